@@ -1,6 +1,11 @@
 #include "Application.h"
 #include "imgui/imgui.h"
 #include "classes/TicTacToe.h"
+#include "classes/Profiler.h"
+#include <algorithm>
+#include <cfloat>
+#include <thread>
+#include <vector>
 
 namespace ClassGame {
         //
@@ -18,16 +23,89 @@ namespace ClassGame {
         int player1Losses = 0;
         int player1Draws = 0;
 
+        // board used by the next new game
+        int boardColumns = 3;
+        int boardRows = 3;
+        int boardWinLength = 3;
+
+        // stop redrawing when nothing changes, and cap the frame rate when something does
+        bool sleepWhenIdle = true;
+        int maxFrameRate = 60;
+
+        //
+        // clear the board and start over
+        //
+        void ResetGame()
+        {
+            game->stopGame();
+            game->setUpBoard();
+            gameOver = false;
+            gameWinner = -1;
+        }
+
         //
         // game starting point
         // this is called by the main render loop in main.cpp
         //
         void GameStartUp() 
         {
+            // every sprite draws out of one texture
+            TextureCache::shared().buildAtlas();
             game = new TicTacToe();
             game->setUpBoard();
         }
 
+        //
+        // percentiles for every profiled section, the frame time histogram and
+        // a button to capture a trace for chrome://tracing
+        //
+        void ShowProfiler()
+        {
+            static std::vector<ProfileStats> stats;
+            static std::vector<float> frameTimes;
+            Profiler &profiler = Profiler::shared();
+
+            ImGui::Begin("Profiler");
+            profiler.stats(stats);
+            if (ImGui::BeginTable("Sections", 6, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp)) {
+                ImGui::TableSetupColumn("Section");
+                ImGui::TableSetupColumn("Samples");
+                ImGui::TableSetupColumn("p50 ms");
+                ImGui::TableSetupColumn("p95 ms");
+                ImGui::TableSetupColumn("p99 ms");
+                ImGui::TableSetupColumn("max ms");
+                ImGui::TableHeadersRow();
+                for (const ProfileStats &section : stats) {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn(); ImGui::TextUnformatted(section.name);
+                    ImGui::TableNextColumn(); ImGui::Text("%d", section.count);
+                    ImGui::TableNextColumn(); ImGui::Text("%.3f", section.p50);
+                    ImGui::TableNextColumn(); ImGui::Text("%.3f", section.p95);
+                    ImGui::TableNextColumn(); ImGui::Text("%.3f", section.p99);
+                    ImGui::TableNextColumn(); ImGui::Text("%.3f", section.max);
+                }
+                ImGui::EndTable();
+            }
+
+            profiler.history("RenderGame", frameTimes);
+            if (!frameTimes.empty()) {
+                ImGui::PlotHistogram("RenderGame ms", frameTimes.data(), (int)frameTimes.size(), 0, nullptr, 0.0f, FLT_MAX, ImVec2(0, 80));
+            }
+
+            if (!profiler.tracing()) {
+                if (ImGui::Button("Start Trace")) {
+                    profiler.startTrace();
+                }
+            } else {
+                if (ImGui::Button("Stop and Save trace.json")) {
+                    profiler.stopTrace("trace.json");
+                }
+                ImGui::SameLine();
+                ImGui::Text("%zu events", profiler.traceEventCount());
+            }
+            ImGui::End();
+        }
+
         //
         // game render loop
         // this is called by the main render loop in main.cpp
@@ -35,6 +113,7 @@ namespace ClassGame {
         //changed the UI to display player statistics and improved
         void RenderGame() 
         {
+                PROFILE_SCOPE("RenderGame");
                 ImGui::DockSpaceOverViewport();
 
                 ImGui::ShowDemoWindow();
@@ -44,14 +123,50 @@ namespace ClassGame {
                 
                 ImGui::Begin("Settings");
                 ImGui::Text("Current Player Number: %d", game->getCurrentPlayer()->playerNumber());
-                ImGui::Text("Current Board State: %s", game->stateString().c_str());
+                static std::string boardState;
+                game->writeStateString(boardState);
+                ImGui::Text("Current Board State: %s", boardState.c_str());
                 
                 // AI Toggle Button
                 ImGui::Separator();
                 if (ImGui::Button(game->_aiEnabled ? "Disable AI" : "Enable AI")) {
                     game->_aiEnabled = !game->_aiEnabled;
                 }
+                ImGui::SameLine();
+                ImGui::Checkbox("AI vs AI", &game->_gameOptions.AIvsAI);
+                int aiMode = game->_aiMode;
+                ImGui::RadioButton("Negamax", &aiMode, kAIModeNegamax);
+                ImGui::SameLine();
+                ImGui::RadioButton("Solved Table", &aiMode, kAIModeSolvedTable);
+                ImGui::SameLine();
+                ImGui::RadioButton("MCTS", &aiMode, kAIModeMCTS);
+                game->_aiMode = (AIMode)aiMode;
+                ImGui::SliderInt("AI Time (ms)", &game->_gameOptions.AITimeBudget, 10, 5000);
+                ImGui::SliderInt("AI Threads", &game->_gameOptions.AIThreads, 1, std::max((int)std::thread::hardware_concurrency(), 1));
+                ImGui::Text("Last AI search: %d nodes, depth %d", game->_gameOptions.AIDepthSearches, game->_gameOptions.AIMAXDepth);
+                if (game->_gameOptions.AISearchTime > 0) {
+                    ImGui::Text("  %d ms, %.0f nodes/sec", game->_gameOptions.AISearchTime,
+                                game->_gameOptions.AIDepthSearches * 1000.0 / game->_gameOptions.AISearchTime);
+                }
+                if (game->aiThinking()) {
+                    ImGui::Text("AI is thinking...");
+                }
                 
+                // Board size, k in a row on any grid
+                ImGui::Separator();
+                ImGui::SliderInt("Columns", &boardColumns, 3, 19);
+                ImGui::SliderInt("Rows", &boardRows, 3, 19);
+                ImGui::SliderInt("In a Row", &boardWinLength, 3, std::max(boardColumns, boardRows));
+                if (ImGui::Button("New Board")) {
+                    game->setBoardSize(boardColumns, boardRows, boardWinLength);
+                    ResetGame();
+                }
+
+                // Rendering
+                ImGui::Separator();
+                ImGui::Checkbox("Sleep When Idle", &sleepWhenIdle);
+                ImGui::SliderInt("Max FPS", &maxFrameRate, 0, 240, maxFrameRate ? "%d" : "vsync");
+
                 //PLAYER 0 STATS
                 ImGui::Separator();
                 ImGui::Text("Player 0 (X) Stats:");
@@ -78,14 +193,13 @@ namespace ClassGame {
                         ImGui::Text("Winner: Player %d", gameWinner);
                     }
                     if (ImGui::Button("Reset Game")) {
-                        game->stopGame();
-                        game->setUpBoard();
-                        gameOver = false;
-                        gameWinner = -1;
+                        ResetGame();
                     }
                 }
                 ImGui::End();
 
+                ShowProfiler();
+
                 ImGui::Begin("GameWindow");
                 game->drawFrame();
                 ImGui::End();
@@ -96,6 +210,23 @@ namespace ClassGame {
                 }
         }
 
+        //
+        // the AI has to be polled every frame until its move is on the board,
+        // everything else on screen only changes in response to input
+        //
+        bool IsAnimating()
+        {
+            if (!sleepWhenIdle) {
+                return true;
+            }
+            return game && !gameOver && game->aiPending();
+        }
+
+        int MaxFrameRate()
+        {
+            return maxFrameRate;
+        }
+
         // end turn is called by the game code at the end of each turn
         // this is where we check for a winner
         //
@@ -103,6 +234,7 @@ namespace ClassGame {
 
         void EndOfTurn() 
         {
+            PROFILE_SCOPE("EndOfTurn");
             Player *winner = game->checkForWinner();
             if (winner)
             {
@@ -118,7 +250,7 @@ namespace ClassGame {
                     player0Losses++;
                 }
             }
-            if (game->checkForDraw()) {
+            else if (game->checkForDraw()) {
                 gameOver = true;
                 gameWinner = -1;
                 
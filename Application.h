@@ -4,4 +4,8 @@ namespace ClassGame {
     void GameStartUp();
     void RenderGame();
     void EndOfTurn();
+    // true while the screen changes without any input, the main loop only sleeps when this is false
+    bool IsAnimating();
+    // frames per second the main loop is held to, 0 leaves it to vsync
+    int  MaxFrameRate();
 }
@@ -0,0 +1,55 @@
+//
+// build step: decode every png in the resources directory, pack them into one
+// atlas and write it out as a blob the game loads at startup without decoding
+//
+// bundle_assets <resources directory> <output file>
+//
+
+#include "classes/TextureAtlas.h"
+#include <cstdio>
+#include <filesystem>
+#include <algorithm>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "classes/stb_image.h"
+
+int main(int argc, char **argv)
+{
+    if (argc != 3) {
+        printf("usage: bundle_assets <resources directory> <output file>\n");
+        return 2;
+    }
+
+    std::vector<AtlasImage> images;
+    std::error_code error;
+    for (const auto &entry : std::filesystem::directory_iterator(argv[1], error)) {
+        if (entry.path().extension() != ".png") {
+            continue;
+        }
+        AtlasImage image = { entry.path().filename().string(), 0, 0, {} };
+        unsigned char *pixels = stbi_load(entry.path().string().c_str(), &image.width, &image.height, NULL, 4);
+        if (!pixels) {
+            printf("bundle_assets: can't decode %s\n", entry.path().string().c_str());
+            return 1;
+        }
+        image.pixels.assign(pixels, pixels + (size_t)image.width * image.height * 4);
+        stbi_image_free(pixels);
+        images.push_back(std::move(image));
+    }
+    if (error) {
+        printf("bundle_assets: can't read %s\n", argv[1]);
+        return 1;
+    }
+    // directory order isn't stable, sort so the same inputs give the same bundle
+    std::sort(images.begin(), images.end(), [](const AtlasImage &a, const AtlasImage &b) {
+        return a.name < b.name;
+    });
+
+    TextureAtlas atlas;
+    if (!atlas.pack(images) || !atlas.save(argv[2])) {
+        printf("bundle_assets: can't write %s\n", argv[2]);
+        return 1;
+    }
+    printf("bundle_assets: %d images in a %dx%d atlas\n", (int)atlas.entries.size(), atlas.width, atlas.height);
+    return 0;
+}
@@ -1,7 +1,32 @@
 
 #include "Bit.h"
 #include "BitHolder.h"
+#include "ObjectPool.h"
 
+// the pool outlives every bit as long as no bit is deleted during static destruction
+static BlockPool<sizeof(Bit)> &bitPool()
+{
+	static BlockPool<sizeof(Bit)> pool;
+	return pool;
+}
+
+void *Bit::operator new(size_t size)
+{
+	// subclasses bigger than a Bit don't fit in the blocks
+	if (size != sizeof(Bit)) {
+		return ::operator new(size);
+	}
+	return bitPool().allocate();
+}
+
+void Bit::operator delete(void *pointer, size_t size)
+{
+	if (size != sizeof(Bit)) {
+		::operator delete(pointer);
+		return;
+	}
+	bitPool().deallocate(pointer);
+}
 
 Bit::~Bit()
 {
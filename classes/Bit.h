@@ -27,6 +27,10 @@ public:
 	
 	~Bit();
 
+	// bits come from a pool, so placing and capturing pieces doesn't hit the heap
+	static void	*operator new(size_t size);
+	static void	operator delete(void *pointer, size_t size);
+
 	// helper functions
 	bool 		getPickedUp();
 	void 		setPickedUp(bool yes);
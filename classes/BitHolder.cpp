@@ -1,5 +1,7 @@
 #include "BitHolder.h"
 #include "Bit.h"
+#include "Player.h"
+#include "Zobrist.h"
 
 BitHolder::~BitHolder()
 {
@@ -17,6 +19,7 @@ Bit* BitHolder::bit()
 {
 	if (_bit && _bit->getParent() != this && !_bit->getPickedUp())
 	{
+		clearBitKey();
 		_bit->release();
 		_bit = nullptr;
 	}
@@ -27,12 +30,18 @@ void BitHolder::setBit(Bit* abit)
 {
 	if (abit != (void *)bit()) {
 		if (_bit) {
+			clearBitKey();
 			_bit->release();
 		}
 		_bit = abit;
 		if (_bit) {
 			_bit->retain();
 			_bit->setParent(this);
+			if (_zobristKey) {
+				Player *owner = _bit->getOwner();
+				_bitKey = zobristKey(_zobristCell, owner ? owner->playerNumber() : 0);
+				*_zobristKey ^= _bitKey;
+			}
 		}
 	}
 }
@@ -40,11 +49,33 @@ void BitHolder::setBit(Bit* abit)
 void BitHolder::destroyBit()
 {
 	if (_bit) {
+		clearBitKey();
 		_bit->release();
 		_bit = nullptr;
 	}
 }
 
+void BitHolder::setZobristSlot(uint64_t *key, int cell)
+{
+	// the piece already here moves from the old key to the new one
+	clearBitKey();
+	_zobristKey = key;
+	_zobristCell = cell;
+	if (_bit && _zobristKey) {
+		Player *owner = _bit->getOwner();
+		_bitKey = zobristKey(_zobristCell, owner ? owner->playerNumber() : 0);
+		*_zobristKey ^= _bitKey;
+	}
+}
+
+void BitHolder::clearBitKey()
+{
+	if (_zobristKey) {
+		*_zobristKey ^= _bitKey;
+	}
+	_bitKey = 0;
+}
+
 Bit* BitHolder::canDragBit(Bit *bit)
 {
 	if (bit->getParent() == this && bit->friendly()) {
@@ -6,7 +6,7 @@ class Bit;
 class BitHolder : public Sprite
 {
 public:
-	BitHolder() : Sprite() { _bit = nullptr; _gameTag = 0; };
+	BitHolder() : Sprite() { _bit = nullptr; _gameTag = 0; _zobristKey = nullptr; _zobristCell = 0; _bitKey = 0; };
 	~BitHolder();
 
 	// current piece or nullptr if empty
@@ -20,6 +20,9 @@ public:
 	int		gameTag() { return _gameTag; };
 	// set the gametag
 	void	setGameTag(int tag) { _gameTag = tag; };
+	// every bit set into or taken out of this holder is xored into *key as the
+	// owner's piece on cell, see Game::trackHolder
+	void	setZobristSlot(uint64_t *key, int cell);
 	// convenience function to see if the holder is empty
 	virtual bool	empty() { return _bit == nullptr; };
 
@@ -49,7 +52,14 @@ public:
 	virtual void	initHolder(const ImVec2 &position, const ImVec4 &color, const char *spriteName);
 
 protected:
+	// the bit left the holder, take its key back out
+	void	clearBitKey();
+
 	Bit		*_bit;
 	int		_gameTag;
+	uint64_t	*_zobristKey;
+	int		_zobristCell;
+	// what the current bit added to *_zobristKey
+	uint64_t	_bitKey;
 };
 
@@ -13,7 +13,9 @@ public:
     };
 
     Entity() : _entityType(EntityNone), _parent(nullptr), _retainCount(0) {};
-    Entity(EntityType type) : _entityType(type) {};
+    Entity(EntityType type) : _entityType(type), _parent(nullptr), _retainCount(0) {};
+    // release() deletes through an Entity pointer, so the subclass destructors have to run
+    virtual ~Entity() {}
 
     EntityType getEntityType() {return _entityType; }
     
@@ -2,6 +2,9 @@
 #include "Bit.h"
 #include "BitHolder.h"
 #include "Turn.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <thread>
 #include "../Application.h"
 
 Game::Game()
@@ -15,21 +18,29 @@ Game::Game()
 	_gameOptions.rowY = 0;
 	_gameOptions.score = 0;
 	_gameOptions.AIDepthSearches = 0;
+	_gameOptions.AIMAXDepth = 0;
+	_gameOptions.AITimeBudget = 250;
+	_gameOptions.AISearchTime = 0;
+	_gameOptions.AIThreads = std::max((int)std::thread::hardware_concurrency(), 1);
 	_gameOptions.AIvsAI = false;
 	
+	_gridOrigin = ImVec2(0, 0);
+	_gridCellSize = 0;
+	_hoveredHolder = nullptr;
+	_zobristKey = 0;
+
 	_score = 0;
 	_table = nullptr;
 	_winner = nullptr;
 	_lastMove = "";
 	_gameNumber = -1;
+	_turnsUsed = 0;
 }
 
 
 Game::~Game()
 {
-	for (auto & _turn : _turns) {
-		delete _turn;
-	}
+	// the turns belong to _turnArena
 	_turns.clear();
 	for (auto & _player : _players) {
 		delete _player;
@@ -45,23 +56,44 @@ Game::~Game()
 
 void Game::setNumberOfPlayers(unsigned int n)
 {
-	_players.clear();
-	for (unsigned int i = 1; i <= n; i++)
-	{
-		Player *player = Player::initWithGame(this);
-//		player->setName( std::format( "Player-{}", i ) );
-		player->setName( "Player" );
-		player->setPlayerNumber(i-1);			// player numbers are zero-based
-		_players.push_back(player);
+	// the same players carry over from game to game, pieces still on the board point at them
+	if (_players.size() != n) {
+		for (auto & _player : _players) {
+			delete _player;
+		}
+		_players.clear();
+		for (unsigned int i = 1; i <= n; i++)
+		{
+			Player *player = Player::initWithGame(this);
+//			player->setName( std::format( "Player-{}", i ) );
+			player->setName( "Player" );
+			player->setPlayerNumber(i-1);			// player numbers are zero-based
+			_players.push_back(player);
+		}
 	}
 	_winner = nullptr;
 	_gameNumber = 0;
 	_gameOptions.numberOfPlayers = n;
-	Turn *turn = Turn::initStartOfGame(this);
+
+	// a new game reuses the turns of the last one
 	_turns.clear();
+	_turnsUsed = 0;
+	Turn *turn = allocateTurn();
+	turn->_game = this;
+	turn->_status = kTurnFinished;
 	_turns.push_back(turn);
 }
 
+Turn *Game::allocateTurn()
+{
+	if (_turnsUsed == _turnArena.size()) {
+		_turnArena.emplace_back();
+	}
+	Turn *turn = &_turnArena[_turnsUsed++];
+	turn->reset();
+	return turn;
+}
+
 void Game::setAIPlayer(unsigned int playerNumber)
 {
 	_players.at(playerNumber)->setAIPlayer(true);
@@ -71,19 +103,36 @@ void Game::setAIPlayer(unsigned int playerNumber)
 
 void Game::startGame()
 {
-	std::string startState = stateString();
+	// the keyframe has every piece already on the board
+	_pendingChanges.clear();
+	PackedBoardState board;
+	getPackedState(board);
 	Turn *turn = _turns.at(0);
-	turn->_boardState = startState;
+	turn->setKeyframe(board);
 	turn->_gameNumber = _gameNumber;
 	_gameOptions.currentTurnNo = 0;
 }
 
+void Game::recordChange(int index, int value)
+{
+	_pendingChanges.push_back({ (uint16_t)index, (uint8_t)value });
+}
+
 void Game::endTurn()
 {
 	_gameOptions.currentTurnNo++;
-	std::string startState = stateString();
-	Turn *turn = new Turn;
-	turn->_boardState = stateString();
+	Turn *turn = allocateTurn();
+	turn->_game = this;
+
+	// the cells the game recorded as it changed them, usually the one piece just placed
+	turn->_changes.swap(_pendingChanges);
+	_pendingChanges.clear();
+	if (_turns.size() % Turn::kKeyframeInterval == 0) {
+		PackedBoardState board;
+		getPackedState(board);
+		turn->setKeyframe(board);
+	}
+
 	turn->_date = (int)_gameOptions.currentTurnNo;
 	turn->_score = _score;
 	turn->_gameNumber = _gameNumber;
@@ -91,34 +140,59 @@ void Game::endTurn()
 	ClassGame::EndOfTurn();
 }
 
+void Game::boardStateAt(size_t turn, PackedBoardState &state) const
+{
+	state.clear(0);
+	if (turn >= _turns.size()) {
+		return;
+	}
+	size_t keyframe = turn;
+	while (!_turns[keyframe]->isKeyframe() && keyframe > 0) {
+		keyframe--;
+	}
+	_turns[keyframe]->getKeyframe(state);
+	for (size_t i = keyframe + 1; i <= turn; i++) {
+		for (const TurnChange &change : _turns[i]->_changes) {
+			state.set(change.index, change.value);
+		}
+	}
+}
+
+// the headless build has no ImGui window to read the mouse from or draw into
+#ifndef HEADLESS
+
 void Game::scanForMouse()
 {
+    PROFILE_SCOPE("scanForMouse");
     //if (gameHasAI() && getCurrentPlayer()->isAIPlayer()) 
     //{
     //    updateAI();
     //    return;
     //}
 
+    // back to the coordinates drawFrame lays the board out in
     ImVec2 mousePos = ImGui::GetMousePos();
-    mousePos.x -= ImGui::GetWindowPos().x;
-    mousePos.y -= ImGui::GetWindowPos().y;
+    mousePos.x -= ImGui::GetWindowPos().x - ImGui::GetScrollX();
+    mousePos.y -= ImGui::GetWindowPos().y - ImGui::GetScrollY();
 
-    for (int y=0; y<_gameOptions.rowY; y++) {
-        for (int x=0; x<_gameOptions.rowX; x++) {
-			BitHolder &holder = getHolderAt(x, y);
-            if (holder.isMouseOver(mousePos)) {
-                if (ImGui::IsMouseClicked(0)) {
-                    if (actionForEmptyHolder(&holder)) {
-                        endTurn();
-                    }
-                } else {
-                    holder.setHighlighted(true);
-                }
-            } else {
-                holder.setHighlighted(false);
-            }
+    BitHolder *holder = holderAtPoint(mousePos);
+    const bool clicked = holder && ImGui::IsMouseClicked(0);
+
+    // only the holder leaving and the one entering change
+    BitHolder *hovered = clicked ? nullptr : holder;
+    if (hovered != _hoveredHolder) {
+        if (_hoveredHolder) {
+            _hoveredHolder->setHighlighted(false);
+        }
+        if (hovered) {
+            hovered->setHighlighted(true);
         }
-    }    
+        _hoveredHolder = hovered;
+    }
+
+    if (clicked && actionForEmptyHolder(holder)) {
+        endTurn();
+    }
 }
 
 //
@@ -127,17 +201,71 @@ void Game::scanForMouse()
 //
 void Game::drawFrame()
 {
+    PROFILE_SCOPE("drawFrame");
     scanForMouse();
 
+    // every square and piece goes straight into the window's draw list, no widgets,
+    // squares first so the pieces land on top
+    ImDrawList *drawList = ImGui::GetWindowDrawList();
+    const ImVec2 origin(ImGui::GetWindowPos().x - ImGui::GetScrollX(), ImGui::GetWindowPos().y - ImGui::GetScrollY());
+    ImVec2 extent(0, 0);
     for (int y=0; y<_gameOptions.rowY; y++) {
         for (int x=0; x<_gameOptions.rowX; x++) {
 			BitHolder &holder = getHolderAt(x, y);
-            holder.paintSprite();
-            if (holder.bit()) {
-                holder.bit()->paintSprite();
+            holder.paintSprite(drawList, origin);
+            extent.x = std::max(extent.x, holder.getPosition().x + holder.getSize().x);
+            extent.y = std::max(extent.y, holder.getPosition().y + holder.getSize().y);
+        }
+    }
+    for (int y=0; y<_gameOptions.rowY; y++) {
+        for (int x=0; x<_gameOptions.rowX; x++) {
+			Bit *bit = getHolderAt(x, y).bit();
+            if (bit) {
+                bit->paintSprite(drawList, origin);
             }
         }
     }
+
+    // one item the size of the board so the window still scrolls to all of it
+    ImGui::SetCursorPos(ImVec2(0, 0));
+    ImGui::Dummy(extent);
+}
+
+#endif
+
+void Game::setGridGeometry(const ImVec2 &origin, float cellSize)
+{
+	_gridOrigin = origin;
+	_gridCellSize = cellSize;
+	// the holders may have been rebuilt, the old pointer can't be trusted
+	_hoveredHolder = nullptr;
+}
+
+void Game::trackHolder(BitHolder &holder, int cell)
+{
+	holder.setZobristSlot(&_zobristKey, cell);
+}
+
+BitHolder *Game::holderAtPoint(const ImVec2 &point)
+{
+	if (_gridCellSize > 0) {
+		const float column = (point.x - _gridOrigin.x) / _gridCellSize;
+		const float row = (point.y - _gridOrigin.y) / _gridCellSize;
+		if (column < 0 || row < 0 || column >= _gameOptions.rowX || row >= _gameOptions.rowY) {
+			return nullptr;
+		}
+		return &getHolderAt((int)column, (int)row);
+	}
+
+	for (int y=0; y<_gameOptions.rowY; y++) {
+		for (int x=0; x<_gameOptions.rowX; x++) {
+			BitHolder &holder = getHolderAt(x, y);
+			if (holder.isMouseOver(point)) {
+				return &holder;
+			}
+		}
+	}
+	return nullptr;
 }
 
 void Game::bitMovedFromTo(Bit *bit, BitHolder *src, BitHolder *dst)
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <iostream>
+#include <deque>
 #include <vector>
 #include <string>
 
@@ -21,8 +22,11 @@ struct GameOptions
 	int gameNumber;
 	unsigned int currentTurnNo;
 	int score;
-	int AIDepthSearches;
-	int AIMAXDepth;
+	int AIDepthSearches;	// nodes searched by the last AI move
+	int AIMAXDepth;			// depth the last AI move finished searching to
+	int AITimeBudget;		// milliseconds the AI may think per move
+	int AISearchTime;		// milliseconds the last AI move actually took
+	int AIThreads;			// threads the AI searches with
 	bool AIvsAI;
 };
 
@@ -41,6 +45,13 @@ public:
 
 	// end the current game turn
 	void	endTurn();
+	// games call this for every cell they change, with its new packed value
+	// endTurn files them under the turn, so the board is never read back to find the move
+	void	recordChange(int index, int value);
+	// a blank turn from this game's arena, valid until the next setNumberOfPlayers
+	Turn	*allocateTurn();
+	// rebuild the board as it was after turn (0 is the start of the game)
+	void	boardStateAt(size_t turn, PackedBoardState &state) const;
 	
 	// Should return true if it is legal for the given bit to be moved from its current holder.
 	// Default implementation always returns true. 
@@ -79,10 +90,24 @@ public:
 	virtual		std::string	initialStateString() = 0;
 	virtual		std::string stateString() const = 0;
 	virtual		void setStateString(const std::string &s) = 0;
+	// stateString into a caller's buffer, games override it to skip the temporary string
+	virtual		void writeStateString(std::string &s) const { s = stateString(); }
+	// the board in the packed encoding the turn history keeps its keyframes in
+	virtual		void getPackedState(PackedBoardState &state) const = 0;
     
 	void		setNumberOfPlayers(unsigned int playerCount);
 	void		setAIPlayer(unsigned int playerNumber);
     void        scanForMouse();
+	// games laid out on an even grid give its top left corner and square size here,
+	// so the mouse maps straight to a holder instead of testing every one of them
+	void		setGridGeometry(const ImVec2 &origin, float cellSize);
+	// holder under a point in window coordinates, nullptr if there isn't one
+	BitHolder	*holderAtPoint(const ImVec2 &point);
+	// zobrist key of the pieces in every tracked holder, kept up to date by the holders
+	// themselves so it costs nothing to read. games call trackHolder once per holder
+	// with its cell number (below ZobristTable::kMaxCells) when they lay out the board
+	uint64_t	zobristKey() const { return _zobristKey; }
+	void		trackHolder(BitHolder &holder, int cell);
 	// function to return pointer to the [][] array of bitholders
 	virtual BitHolder &getHolderAt(const int x, const int y) = 0;
 	
@@ -96,6 +121,7 @@ public:
 	Player					*_winner;
 
 	std::vector<Player*>	_players;
+	// turns of the current game, they live in _turnArena
 	std::vector<Turn*>		_turns;
 
 	int						_score;
@@ -104,5 +130,19 @@ public:
 	GameOptions 			_gameOptions;
 
 	int						_gameNumber;
+
+private:
+	// every Turn this game has ever needed, reused from the front each new game
+	// a deque so the pointers in _turns stay put as it grows
+	std::deque<Turn>		_turnArena;
+	size_t					_turnsUsed;
+	// cells changed since the last endTurn, swapped into the turn so neither reallocates
+	std::vector<TurnChange>	_pendingChanges;
+	// grid geometry from setGridGeometry, a cell size of 0 means test every holder
+	ImVec2					_gridOrigin;
+	float					_gridCellSize;
+	// the one holder scanForMouse has highlighted
+	BitHolder				*_hoveredHolder;
+	uint64_t				_zobristKey;
 };
 
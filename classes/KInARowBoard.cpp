@@ -0,0 +1,279 @@
+#include "KInARowBoard.h"
+#include <algorithm>
+
+// right, down, down-right, down-left
+static const int kDirections[4][2] = { {1, 0}, {0, 1}, {1, 1}, {-1, 1} };
+
+// a window with only one player's pieces, by how many it is still missing
+// 1 missing is a four on a five in a row board, 2 a three and so on
+static const int kRunScores[] = { 0, 4096, 512, 64, 8, 2 };
+static const int kRunScoreCount = sizeof(kRunScores) / sizeof(kRunScores[0]);
+
+//
+// a window from the side of the player with mine pieces in it
+//
+static int windowScore(int mine, int theirs, int winLength)
+{
+    if (mine > 0 && theirs == 0) {
+        const int missing = winLength - mine;
+        return (missing < kRunScoreCount) ? kRunScores[missing] : 1;
+    }
+    if (theirs > 0 && mine == 0) {
+        const int missing = winLength - theirs;
+        return -((missing < kRunScoreCount) ? kRunScores[missing] : 1);
+    }
+    return 0;
+}
+
+KInARowBoard::KInARowBoard()
+{
+    reset(3, 3, 3);
+}
+
+void KInARowBoard::reset(int width, int height, int winLength)
+{
+    _width = std::clamp(width, 1, kMaxDimension);
+    _height = std::clamp(height, 1, kMaxDimension);
+    _winLength = std::clamp(winLength, 1, std::max(_width, _height));
+    _pieceCount = 0;
+    _hash = 0;
+    _score = 0;
+    _winningWindows[0] = 0;
+    _winningWindows[1] = 0;
+    _cells.assign(cellCount(), -1);
+    _nearbyPieces.assign(cellCount(), 0);
+    _candidateSlot.assign(cellCount(), -1);
+    _candidates.clear();
+    _candidates.reserve(cellCount());
+
+    // collect every window as its start cell and direction
+    std::vector<int> windowStart;
+    std::vector<int> windowDirection;
+    for (int d = 0; d < 4; d++) {
+        const int dx = kDirections[d][0];
+        const int dy = kDirections[d][1];
+        for (int y = 0; y < _height; y++) {
+            for (int x = 0; x < _width; x++) {
+                int endX = x + dx * (_winLength - 1);
+                int endY = y + dy * (_winLength - 1);
+                if (endX < 0 || endX >= _width || endY >= _height) {
+                    continue;
+                }
+                // a 1 long window would otherwise be counted once per direction
+                if (_winLength == 1 && d > 0) {
+                    continue;
+                }
+                windowStart.push_back(cellIndex(x, y));
+                windowDirection.push_back(d);
+            }
+        }
+    }
+
+    const int stride = _winLength + 1;
+    _placeGain.assign(stride * stride, 0);
+    for (int mine = 0; mine < _winLength; mine++) {
+        for (int theirs = 0; theirs <= _winLength; theirs++) {
+            _placeGain[mine * stride + theirs] = windowScore(mine + 1, theirs, _winLength) - windowScore(mine, theirs, _winLength);
+        }
+    }
+
+    const int windowCount = (int)windowStart.size();
+    _windowCounts[0].assign(windowCount, 0);
+    _windowCounts[1].assign(windowCount, 0);
+    _windowFirstCell = windowStart;
+    _windowStep.resize(windowCount);
+    for (int w = 0; w < windowCount; w++) {
+        _windowStep[w] = kDirections[windowDirection[w]][0] + kDirections[windowDirection[w]][1] * _width;
+    }
+    // with 1 in a row every empty window is already one piece short
+    _threatWindows[0] = (_winLength == 1) ? windowCount : 0;
+    _threatWindows[1] = _threatWindows[0];
+
+    // two passes to lay the per cell window lists out back to back
+    _cellWindowStart.assign(cellCount() + 1, 0);
+    for (int pass = 0; pass < 2; pass++) {
+        std::vector<int> fill(_cellWindowStart.begin(), _cellWindowStart.end() - 1);
+        if (pass == 1) {
+            _cellWindows.resize(_cellWindowStart.back());
+        }
+        for (int w = 0; w < windowCount; w++) {
+            int x = windowStart[w] % _width;
+            int y = windowStart[w] / _width;
+            for (int i = 0; i < _winLength; i++) {
+                int cell = cellIndex(x + kDirections[windowDirection[w]][0] * i, y + kDirections[windowDirection[w]][1] * i);
+                if (pass == 0) {
+                    _cellWindowStart[cell + 1]++;
+                } else {
+                    _cellWindows[fill[cell]++] = w;
+                }
+            }
+        }
+        if (pass == 0) {
+            for (int cell = 0; cell < cellCount(); cell++) {
+                _cellWindowStart[cell + 1] += _cellWindowStart[cell];
+            }
+        }
+    }
+}
+
+void KInARowBoard::addCandidate(int cell)
+{
+    _candidateSlot[cell] = (int)_candidates.size();
+    _candidates.push_back(cell);
+}
+
+void KInARowBoard::dropCandidate(int cell)
+{
+    // the last candidate fills the hole
+    const int slot = _candidateSlot[cell];
+    const int last = _candidates.back();
+    _candidates[slot] = last;
+    _candidateSlot[last] = slot;
+    _candidates.pop_back();
+    _candidateSlot[cell] = -1;
+}
+
+bool KInARowBoard::place(int cell, int player)
+{
+    _cells[cell] = (int8_t)player;
+    _pieceCount++;
+    _hash ^= zobristKey(cell, player);
+
+    if (isCandidate(cell)) {
+        dropCandidate(cell);
+    }
+    const int x = cell % _width;
+    const int y = cell / _width;
+    for (int ny = std::max(y - kCandidateDistance, 0); ny <= std::min(y + kCandidateDistance, _height - 1); ny++) {
+        for (int nx = std::max(x - kCandidateDistance, 0); nx <= std::min(x + kCandidateDistance, _width - 1); nx++) {
+            const int near = cellIndex(nx, ny);
+            if (near != cell && _nearbyPieces[near]++ == 0 && _cells[near] < 0) {
+                addCandidate(near);
+            }
+        }
+    }
+    bool won = false;
+    int gain = 0;
+    const int stride = _winLength + 1;
+    uint8_t *counts = _windowCounts[player].data();
+    const uint8_t *theirs = _windowCounts[1 - player].data();
+    for (int i = _cellWindowStart[cell]; i < _cellWindowStart[cell + 1]; i++) {
+        const int window = _cellWindows[i];
+        gain += _placeGain[counts[window] * stride + theirs[window]];
+        if (theirs[window] == 0) {
+            // one short of a line, or no longer short because it is one
+            _threatWindows[player] += (counts[window] == _winLength - 2) - (counts[window] == _winLength - 1);
+        } else if (counts[window] == 0 && theirs[window] == _winLength - 1) {
+            _threatWindows[1 - player]--;
+        }
+        if (++counts[window] == _winLength) {
+            _winningWindows[player]++;
+            won = true;
+        }
+    }
+    _score += (player == 0) ? gain : -gain;
+    return won;
+}
+
+void KInARowBoard::remove(int cell)
+{
+    int player = _cells[cell];
+    if (player < 0) {
+        return;
+    }
+    _cells[cell] = -1;
+    _pieceCount--;
+    _hash ^= zobristKey(cell, player);
+
+    const int x = cell % _width;
+    const int y = cell / _width;
+    for (int ny = std::max(y - kCandidateDistance, 0); ny <= std::min(y + kCandidateDistance, _height - 1); ny++) {
+        for (int nx = std::max(x - kCandidateDistance, 0); nx <= std::min(x + kCandidateDistance, _width - 1); nx++) {
+            const int near = cellIndex(nx, ny);
+            if (near != cell && --_nearbyPieces[near] == 0 && isCandidate(near)) {
+                dropCandidate(near);
+            }
+        }
+    }
+    if (_nearbyPieces[cell] > 0) {
+        addCandidate(cell);
+    }
+
+    int gain = 0;
+    const int stride = _winLength + 1;
+    uint8_t *counts = _windowCounts[player].data();
+    const uint8_t *theirs = _windowCounts[1 - player].data();
+    for (int i = _cellWindowStart[cell]; i < _cellWindowStart[cell + 1]; i++) {
+        const int window = _cellWindows[i];
+        if (counts[window]-- == _winLength) {
+            _winningWindows[player]--;
+        }
+        gain += _placeGain[counts[window] * stride + theirs[window]];
+        if (theirs[window] == 0) {
+            _threatWindows[player] += (counts[window] == _winLength - 1) - (counts[window] == _winLength - 2);
+        } else if (counts[window] == 0 && theirs[window] == _winLength - 1) {
+            _threatWindows[1 - player]++;
+        }
+    }
+    _score -= (player == 0) ? gain : -gain;
+}
+
+//
+// the one empty cell of each window player is a piece short in, skipping repeats
+//
+static int addWinningCell(const std::vector<int8_t> &cells, int first, int step, int length, int *out, int count)
+{
+    for (int i = 0; i < length; i++) {
+        const int cell = first + i * step;
+        if (cells[cell] < 0) {
+            if (std::find(out, out + count, cell) == out + count) {
+                out[count++] = cell;
+            }
+            break;
+        }
+    }
+    return count;
+}
+
+int KInARowBoard::winningCells(int player, int *cells) const
+{
+    int count = 0;
+    if (!hasThreat(player)) {
+        return 0;
+    }
+    const uint8_t *mine = _windowCounts[player].data();
+    const uint8_t *theirs = _windowCounts[1 - player].data();
+    for (int w = 0; w < (int)_windowFirstCell.size(); w++) {
+        if (mine[w] == _winLength - 1 && theirs[w] == 0) {
+            count = addWinningCell(_cells, _windowFirstCell[w], _windowStep[w], _winLength, cells, count);
+        }
+    }
+    return count;
+}
+
+int KInARowBoard::winningCellsThrough(int cell, int player, int *cells) const
+{
+    int count = 0;
+    const uint8_t *mine = _windowCounts[player].data();
+    const uint8_t *theirs = _windowCounts[1 - player].data();
+    for (int i = _cellWindowStart[cell]; i < _cellWindowStart[cell + 1]; i++) {
+        const int w = _cellWindows[i];
+        if (mine[w] == _winLength - 1 && theirs[w] == 0) {
+            count = addWinningCell(_cells, _windowFirstCell[w], _windowStep[w], _winLength, cells, count);
+        }
+    }
+    return count;
+}
+
+bool KInARowBoard::makesRun(int cell, int player, int length) const
+{
+    const uint8_t *mine = _windowCounts[player].data();
+    const uint8_t *theirs = _windowCounts[1 - player].data();
+    for (int i = _cellWindowStart[cell]; i < _cellWindowStart[cell + 1]; i++) {
+        const int w = _cellWindows[i];
+        if (mine[w] == length - 1 && theirs[w] == 0) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Zobrist.h"
+
+//
+// m,n,k game position: a width x height grid where the first player to get
+// winLength in a row (row, column or diagonal) wins. 3x3 with k = 3 is tic tac toe,
+// 15x15 with k = 5 is five-in-a-row.
+//
+// every run of winLength cells on the board is a "window". each window keeps a
+// piece count per player, updated only for the windows through the cell that
+// changed, so detecting a win after a move looks at no more than 4 * winLength
+// windows instead of rescanning the board.
+//
+// place and remove also keep the zobrist key of the position, so searches can
+// key transposition tables and caches on it without looking at the cells
+//
+// the window counts double as the static evaluation. a window holding pieces of
+// only one player is a run that can still become a line, worth more the fewer
+// pieces it is missing. an open run sits in more such windows than a closed one,
+// so open and closed twos, threes and fours score apart without matching shapes.
+// what a move adds is looked up per window in a table built by reset, so the
+// score changes with the same loop over the windows through the cell.
+//
+// they also keep the candidate moves: the empty cells within kCandidateDistance of
+// some piece. a move far from every piece never matters in a k in a row game, so
+// the searches only look at these, a few dozen cells even on a crowded 19x19
+//
+class KInARowBoard
+{
+public:
+    static constexpr int kMaxDimension = 32;
+    static constexpr int kCandidateDistance = 2;
+
+    KInARowBoard();
+
+    // size the board and clear it
+    void        reset(int width, int height, int winLength);
+
+    int         width() const { return _width; }
+    int         height() const { return _height; }
+    int         winLength() const { return _winLength; }
+    int         cellCount() const { return _width * _height; }
+    int         cellIndex(int x, int y) const { return y * _width + x; }
+
+    // player number at cell, -1 if empty
+    int         ownerAt(int cell) const { return _cells[cell]; }
+    bool        empty(int cell) const { return _cells[cell] < 0; }
+    int         pieceCount() const { return _pieceCount; }
+    bool        full() const { return _pieceCount == cellCount(); }
+    // zobrist key of the pieces on the board, 0 when it is empty
+    uint64_t    hash() const { return _hash; }
+
+    // player number of the winner, -1 if nobody has winLength in a row
+    int         winner() const { return _winningWindows[0] ? 0 : (_winningWindows[1] ? 1 : -1); }
+    bool        hasWon(int player) const { return _winningWindows[player] > 0; }
+
+    // player has a window one piece short of a line with none of the opponent's
+    // pieces in it, so player wins on their next move unless it is blocked
+    bool        hasThreat(int player) const { return _threatWindows[player] > 0; }
+    // the distinct empty cells that win for player at once, written to cells
+    // (room for cellCount) and counted. winningCellsThrough only looks at lines through cell
+    int         winningCells(int player, int *cells) const;
+    int         winningCellsThrough(int cell, int player, int *cells) const;
+    // would placing player at empty cell give a window with length of player's
+    // pieces and none of the opponent's
+    bool        makesRun(int cell, int player, int length) const;
+
+    // positional score for player, positive when player's runs are worth more
+    // than the opponent's. finished lines aren't counted, check winner() first
+    int         evaluate(int player) const { return player == 0 ? _score : -_score; }
+
+    // candidate moves in no particular order, none on an empty board
+    int         candidateCount() const { return (int)_candidates.size(); }
+    int         candidate(int i) const { return _candidates[i]; }
+    bool        isCandidate(int cell) const { return _candidateSlot[cell] >= 0; }
+
+    // make / unmake a move; place returns true if the move completes a line
+    bool        place(int cell, int player);
+    void        remove(int cell);
+
+private:
+    void        addCandidate(int cell);
+    void        dropCandidate(int cell);
+
+    int                     _width;
+    int                     _height;
+    int                     _winLength;
+    int                     _pieceCount;
+    int                     _winningWindows[2];
+    // windows each player is one piece short in, with no opponent pieces
+    int                     _threatWindows[2];
+    uint64_t                _hash;
+    // evaluation from player 0's side
+    int                     _score;
+
+    std::vector<int8_t>     _cells;
+    // pieces each player has in each window
+    std::vector<uint8_t>    _windowCounts[2];
+    // first cell of each window and the index step to its next cell
+    std::vector<int>        _windowFirstCell;
+    std::vector<int>        _windowStep;
+    // windows through each cell, cell c owns _cellWindows[_cellWindowStart[c] .. _cellWindowStart[c + 1])
+    std::vector<int>        _cellWindowStart;
+    std::vector<int>        _cellWindows;
+    // what the mover gains when their count in a window goes from mine to mine + 1,
+    // indexed mine * (winLength + 1) + the opponent's count
+    std::vector<int>        _placeGain;
+    // pieces within kCandidateDistance of each cell, not counting the cell itself
+    std::vector<uint8_t>    _nearbyPieces;
+    // candidate cells, and where each cell sits in that list (-1 if it isn't there)
+    std::vector<int>        _candidates;
+    std::vector<int>        _candidateSlot;
+};
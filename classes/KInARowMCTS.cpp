@@ -0,0 +1,340 @@
+#include "KInARowMCTS.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+// UCT exploration constant, scores are in [0, 1]
+const float EXPLORATION = 1.0f;
+// visits a leaf needs before it gets children, the rest only play out
+const int EXPAND_VISITS = 2;
+// past this much of the pool the old tree is dropped instead of reused
+const int REUSE_LIMIT = KInARowMCTS::kMaxNodes / 2;
+
+KInARowMCTS::KInARowMCTS()
+{
+    _poolUsed = 0;
+    _root = -1;
+    _rootPlayer = 0;
+    _threadCount = 1;
+    _playoutCount = 0;
+    _depthReached = 0;
+    _elapsedMs = 0;
+    _stop = nullptr;
+    _done = false;
+}
+
+void KInARowMCTS::setThreadCount(int threads)
+{
+    _threadCount = std::max(threads, 1);
+}
+
+uint32_t KInARowMCTS::nextRandom(uint64_t &state)
+{
+    // xorshift64*, plenty for picking playout moves
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return (uint32_t)((state * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+//
+// count nodes off the pool, -1 once it is used up
+//
+int KInARowMCTS::allocate(int count)
+{
+    int first = _poolUsed.fetch_add(count, std::memory_order_relaxed);
+    if (first + count > kMaxNodes) {
+        _poolUsed.fetch_sub(count, std::memory_order_relaxed);
+        return -1;
+    }
+    return first;
+}
+
+//
+// the node for this position in the last search's tree, -1 if it isn't there.
+// only the plies played since then can differ, and at most two of them so the
+// order the pieces went down in is never in doubt
+//
+int KInARowMCTS::reuseRoot(const KInARowBoard &board, int player)
+{
+    if (!_nodes || _root < 0 || _poolUsed.load() > REUSE_LIMIT) {
+        return -1;
+    }
+    if (board.width() != _rootBoard.width() || board.height() != _rootBoard.height() || board.winLength() != _rootBoard.winLength()) {
+        return -1;
+    }
+
+    std::vector<int> added;
+    for (int cell = 0; cell < board.cellCount(); cell++) {
+        const int before = _rootBoard.ownerAt(cell);
+        const int now = board.ownerAt(cell);
+        if (before == now) {
+            continue;
+        }
+        if (before >= 0 || added.size() == 2) {
+            return -1;
+        }
+        added.push_back(cell);
+    }
+
+    int index = _root;
+    int mover = _rootPlayer;
+    while (!added.empty()) {
+        auto played = std::find_if(added.begin(), added.end(), [&](int cell) { return board.ownerAt(cell) == mover; });
+        if (played == added.end()) {
+            return -1;
+        }
+        const int firstChild = _nodes[index].firstChild.load(std::memory_order_acquire);
+        if (firstChild < 0) {
+            return -1;
+        }
+        int next = -1;
+        for (int i = 0; i < _nodes[index].childCount; i++) {
+            if (_nodes[firstChild + i].move == *played) {
+                next = firstChild + i;
+                break;
+            }
+        }
+        if (next < 0) {
+            return -1;
+        }
+        index = next;
+        mover = 1 - mover;
+        added.erase(played);
+    }
+    return (mover == player) ? index : -1;
+}
+
+int KInARowMCTS::findBestMove(const KInARowBoard &board, int player, int timeBudgetMs)
+{
+    const Clock::time_point start = Clock::now();
+    _deadline = start + std::chrono::milliseconds(timeBudgetMs);
+    _playoutCount = 0;
+    _depthReached = 0;
+    _elapsedMs = 0;
+
+    if (board.winner() >= 0 || board.full()) {
+        return -1;
+    }
+    if (!_nodes) {
+        _nodes = std::make_unique<Node[]>(kMaxNodes);
+    }
+
+    _root = reuseRoot(board, player);
+    if (_root < 0) {
+        _poolUsed = 0;
+        _root = allocate(1);
+        Node &root = _nodes[_root];
+        root.visits = 0;
+        root.score = 0;
+        root.firstChild = kUnexpanded;
+        root.move = -1;
+        root.childCount = 0;
+    }
+    _rootPlayer = player;
+    _rootBoard = board;
+
+    _workers.resize(_threadCount);
+    for (size_t i = 0; i < _workers.size(); i++) {
+        Worker &worker = _workers[i];
+        worker.board = board;
+        worker.random = (0x9E3779B97F4A7C15ULL * (i + 1) ^ (uint64_t)start.time_since_epoch().count()) | 1;
+        worker.playouts = 0;
+        worker.deepest = 0;
+    }
+    // the root always gets children, even if the clock has already run out
+    expand(_workers[0], _root, player);
+
+    _done = false;
+    std::vector<std::thread> helpers;
+    for (size_t i = 1; i < _workers.size(); i++) {
+        helpers.emplace_back(&KInARowMCTS::searchThread, this, std::ref(_workers[i]));
+    }
+    searchThread(_workers[0]);
+    for (std::thread &helper : helpers) {
+        helper.join();
+    }
+
+    for (const Worker &worker : _workers) {
+        _playoutCount += worker.playouts;
+        _depthReached = std::max(_depthReached, worker.deepest);
+    }
+
+    // a move that wins on the spot beats any visit count, otherwise the most visited
+    const Node &root = _nodes[_root];
+    const int firstChild = root.firstChild.load();
+    int bestMove = -1;
+    int bestVisits = -1;
+    for (int i = 0; firstChild >= 0 && i < root.childCount; i++) {
+        const Node &child = _nodes[firstChild + i];
+        if (child.firstChild.load() == kTerminalWin) {
+            bestMove = child.move;
+            break;
+        }
+        const int visits = child.visits.load();
+        if (visits > bestVisits) {
+            bestVisits = visits;
+            bestMove = child.move;
+        }
+    }
+
+    _elapsedMs = (int)std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+    return bestMove;
+}
+
+void KInARowMCTS::searchThread(Worker &worker)
+{
+    while (!_done.load(std::memory_order_relaxed)) {
+        iterate(worker);
+        if (Clock::now() >= _deadline || (_stop && _stop->load(std::memory_order_relaxed))) {
+            _done = true;
+        }
+    }
+}
+
+//
+// give node children for every candidate move, false if another thread
+// already is or the pool is full
+//
+bool KInARowMCTS::expand(Worker &worker, int index, int player)
+{
+    Node &node = _nodes[index];
+    int expected = kUnexpanded;
+    if (!node.firstChild.compare_exchange_strong(expected, kExpanding, std::memory_order_acquire)) {
+        return false;
+    }
+
+    // the board's candidate moves, the center on an empty board
+    KInARowBoard &board = worker.board;
+    worker.candidates.clear();
+    if (board.pieceCount() == 0) {
+        worker.candidates.push_back(board.cellIndex(board.width() / 2, board.height() / 2));
+    }
+    for (int i = 0; i < board.candidateCount(); i++) {
+        worker.candidates.push_back(board.candidate(i));
+    }
+
+    const int count = (int)worker.candidates.size();
+    const int first = allocate(count);
+    if (first < 0) {
+        node.firstChild.store(kUnexpanded, std::memory_order_relaxed);
+        return false;
+    }
+    for (int i = 0; i < count; i++) {
+        Node &child = _nodes[first + i];
+        const int cell = worker.candidates[i];
+        const bool won = board.place(cell, player);
+        child.visits.store(0, std::memory_order_relaxed);
+        child.score.store(0, std::memory_order_relaxed);
+        child.firstChild.store(won ? kTerminalWin : (board.full() ? kTerminalDraw : kUnexpanded), std::memory_order_relaxed);
+        child.move = (int16_t)cell;
+        child.childCount = 0;
+        board.remove(cell);
+    }
+    node.childCount = (int16_t)count;
+    node.firstChild.store(first, std::memory_order_release);
+    return true;
+}
+
+int KInARowMCTS::selectChild(const Node &node) const
+{
+    const int first = node.firstChild.load(std::memory_order_acquire);
+    const float logVisits = std::log((float)std::max(node.visits.load(std::memory_order_relaxed), 1));
+    int best = first;
+    float bestValue = -1.0f;
+    for (int i = first; i < first + node.childCount; i++) {
+        const Node &child = _nodes[i];
+        const int visits = child.visits.load(std::memory_order_relaxed);
+        if (visits == 0) {
+            return i;
+        }
+        const float value = child.score.load(std::memory_order_relaxed) / (2.0f * visits)
+                          + EXPLORATION * std::sqrt(logVisits / visits);
+        if (value > bestValue) {
+            bestValue = value;
+            best = i;
+        }
+    }
+    return best;
+}
+
+int KInARowMCTS::playout(Worker &worker, int player)
+{
+    // random moves out of the board's candidates, the list follows every move
+    KInARowBoard &board = worker.board;
+    int winner = -1;
+    const size_t played = worker.moves.size();
+    while (board.candidateCount() > 0) {
+        const int cell = board.candidate(nextRandom(worker.random) % board.candidateCount());
+        worker.moves.push_back(cell);
+        if (board.place(cell, player)) {
+            winner = player;
+            break;
+        }
+        player = 1 - player;
+    }
+    while (worker.moves.size() > played) {
+        board.remove(worker.moves.back());
+        worker.moves.pop_back();
+    }
+    return winner;
+}
+
+//
+// one select, expand, playout, backup pass from the root
+//
+void KInARowMCTS::iterate(Worker &worker)
+{
+    KInARowBoard &board = worker.board;
+    worker.path.clear();
+    worker.moves.clear();
+
+    int index = _root;
+    int player = _rootPlayer;
+    _nodes[index].visits.fetch_add(1, std::memory_order_relaxed);
+    worker.path.push_back(index);
+
+    int winner = -1;
+    while (true) {
+        Node &node = _nodes[index];
+        const int firstChild = node.firstChild.load(std::memory_order_acquire);
+        if (firstChild == kTerminalWin) {
+            // whoever moved into this node won
+            winner = 1 - player;
+            break;
+        }
+        if (firstChild == kTerminalDraw) {
+            break;
+        }
+        if (firstChild < 0) {
+            if (firstChild == kUnexpanded && node.visits.load(std::memory_order_relaxed) > EXPAND_VISITS && expand(worker, index, player)) {
+                continue;
+            }
+            winner = playout(worker, player);
+            break;
+        }
+        index = selectChild(node);
+        // the virtual loss: counted as visited, scored when the playout comes back
+        _nodes[index].visits.fetch_add(1, std::memory_order_relaxed);
+        board.place(_nodes[index].move, player);
+        worker.moves.push_back(_nodes[index].move);
+        worker.path.push_back(index);
+        player = 1 - player;
+    }
+
+    // the player to move at the end of the path is the one who didn't make its last move
+    int mover = 1 - player;
+    for (int i = (int)worker.path.size() - 1; i >= 0; i--) {
+        const int score = (winner == mover) ? 2 : (winner < 0 ? 1 : 0);
+        if (score) {
+            _nodes[worker.path[i]].score.fetch_add(score, std::memory_order_relaxed);
+        }
+        mover = 1 - mover;
+    }
+    for (int i = (int)worker.moves.size() - 1; i >= 0; i--) {
+        board.remove(worker.moves[i]);
+    }
+
+    worker.playouts++;
+    worker.deepest = std::max(worker.deepest, (int)worker.path.size() - 1);
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "KInARowBoard.h"
+
+//
+// monte carlo tree search (UCT) for m,n,k boards too big for alpha-beta to see the
+// end of the game. every iteration walks the tree by UCT, expands the leaf it lands on
+// and finishes the game with random moves out of the board's candidate list, then
+// counts the result back up the path.
+// the move played is the root child visited most.
+//
+// all threads share one tree. a node being walked through carries a virtual loss,
+// a visit with no score, so the other threads spread out instead of piling onto the
+// same line. nodes come out of a fixed pool by index and each node's children sit
+// side by side, expanding a node is one atomic bump of the pool.
+//
+// the tree is kept between moves: when the next search starts one or two plies below
+// the last root, the subtree under those moves becomes the new root
+//
+class KInARowMCTS
+{
+public:
+    // nodes in the pool, 16 bytes each
+    static constexpr int kMaxNodes = 1 << 21;
+
+    KInARowMCTS();
+
+    // best cell for player to move, -1 if the board is full or already won
+    // keeps playing out games until the time budget runs out
+    int         findBestMove(const KInARowBoard &board, int player, int timeBudgetMs);
+    // playouts run by the last findBestMove, over all threads
+    int         playoutCount() const { return _playoutCount; }
+    // deepest the tree reached below the root
+    int         depthReached() const { return _depthReached; }
+    // wall clock time the last findBestMove took
+    int         elapsedMs() const { return _elapsedMs; }
+    // nodes in the tree after the last findBestMove, reused ones included
+    int         nodeCount() const { return _poolUsed.load(); }
+    // when *stop turns true the search stops at the end of the current playout
+    void        setStopFlag(const std::atomic<bool> *stop) { _stop = stop; }
+    // threads sharing the tree, 1 searches on the calling thread only
+    void        setThreadCount(int threads);
+    int         threadCount() const { return _threadCount; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // firstChild values below zero
+    static constexpr int kUnexpanded = -1;
+    static constexpr int kExpanding = -2;
+    // the move into this node ended the game, it is never expanded
+    static constexpr int kTerminalWin = -3;
+    static constexpr int kTerminalDraw = -4;
+
+    struct Node
+    {
+        // real visits plus virtual losses in flight
+        std::atomic<int>    visits;
+        // 2 per win and 1 per draw for the player who made move
+        std::atomic<int>    score;
+        // index of the first child, or one of the codes above
+        std::atomic<int>    firstChild;
+        int16_t             move;
+        int16_t             childCount;
+    };
+
+    // everything one search thread writes to
+    struct Worker
+    {
+        KInARowBoard        board;
+        std::vector<int>    path;
+        std::vector<int>    moves;
+        std::vector<int>    candidates;
+        uint64_t            random = 0;
+        int                 playouts = 0;
+        int                 deepest = 0;
+    };
+
+    void        searchThread(Worker &worker);
+    void        iterate(Worker &worker);
+    bool        expand(Worker &worker, int index, int player);
+    int         selectChild(const Node &node) const;
+    // winner of a random game from the worker's board, -1 for a draw
+    int         playout(Worker &worker, int player);
+    int         reuseRoot(const KInARowBoard &board, int player);
+    int         allocate(int count);
+    static uint32_t nextRandom(uint64_t &state);
+
+    std::unique_ptr<Node[]> _nodes;
+    std::atomic<int>    _poolUsed;
+    int                 _root;
+    int                 _rootPlayer;
+    // the position _root stands for, to find it again next move
+    KInARowBoard        _rootBoard;
+
+    std::vector<Worker> _workers;
+    int                 _threadCount;
+    int                 _playoutCount;
+    int                 _depthReached;
+    int                 _elapsedMs;
+    Clock::time_point   _deadline;
+    const std::atomic<bool> *_stop;
+    std::atomic<bool>   _done;
+};
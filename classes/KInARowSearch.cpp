@@ -0,0 +1,328 @@
+#include "KInARowSearch.h"
+#include <algorithm>
+
+// how many nodes go by between looks at the clock
+const int CLOCK_CHECK_INTERVAL = 1024;
+
+KInARowSearch::KInARowSearch()
+{
+    _nodeCount = 0;
+    _depthReached = 0;
+    _elapsedMs = 0;
+    _canAbort = false;
+    _aborted = false;
+    _stop = nullptr;
+    _rootBestMove = -1;
+    _rootBestScore = -kInfiniteScore;
+    _generation = 0;
+    _busyHelpers = 0;
+    _quit = false;
+    _splitDepth = 0;
+    _splitPlayer = 0;
+    setThreadCount(1);
+}
+
+KInARowSearch::~KInARowSearch()
+{
+    stopHelpers();
+}
+
+//
+// the helpers are only started again when the count changes, the game sets it before every search
+//
+void KInARowSearch::setThreadCount(int threads)
+{
+    threads = std::max(threads, 1);
+    if (threads == (int)_workers.size()) {
+        return;
+    }
+    stopHelpers();
+    _workers.resize(threads);
+    for (int i = 1; i < threads; i++) {
+        _helpers.emplace_back(&KInARowSearch::helperThread, this, i, _generation);
+    }
+}
+
+void KInARowSearch::stopHelpers()
+{
+    {
+        std::lock_guard<std::mutex> lock(_poolLock);
+        _quit = true;
+    }
+    _poolWake.notify_all();
+    for (std::thread &helper : _helpers) {
+        helper.join();
+    }
+    _helpers.clear();
+    _quit = false;
+}
+
+//
+// sleeps until the next root split, takes its share of the root moves and goes back to sleep
+// generation is the split count when the helper was started, anything at or before it
+// isn't this helper's to answer
+//
+void KInARowSearch::helperThread(int index, int generation)
+{
+    std::unique_lock<std::mutex> lock(_poolLock);
+    for (;;) {
+        _poolWake.wait(lock, [&] { return _quit || _generation != generation; });
+        if (_quit) {
+            return;
+        }
+        generation = _generation;
+        const int depth = _splitDepth;
+        const int player = _splitPlayer;
+        lock.unlock();
+        searchRootMoves(_workers[index], depth, player);
+        lock.lock();
+        if (--_busyHelpers == 0) {
+            _poolDone.notify_one();
+        }
+    }
+}
+
+//
+// cells sorted by distance from the center, rebuilt whenever the board size changes
+//
+void KInARowSearch::buildMoveOrder(const KInARowBoard &board)
+{
+    if ((int)_moveOrder.size() == board.cellCount()) {
+        return;
+    }
+    _moveOrder.resize(board.cellCount());
+    for (int cell = 0; cell < board.cellCount(); cell++) {
+        _moveOrder[cell] = cell;
+    }
+    // distances are doubled so the center of an even board is exact
+    auto distance = [&board](int cell) {
+        int dx = std::abs(2 * (cell % board.width()) - (board.width() - 1));
+        int dy = std::abs(2 * (cell / board.width()) - (board.height() - 1));
+        return std::max(dx, dy) * 4 + dx + dy;
+    };
+    std::stable_sort(_moveOrder.begin(), _moveOrder.end(), [&distance](int a, int b) {
+        return distance(a) < distance(b);
+    });
+    _moveRank.resize(board.cellCount());
+    for (int rank = 0; rank < board.cellCount(); rank++) {
+        _moveRank[_moveOrder[rank]] = rank;
+    }
+}
+
+//
+// the board's candidate moves nearest the center first, the center on an empty board
+//
+int KInARowSearch::orderMoves(const KInARowBoard &board, int *moves)
+{
+    const int count = board.candidateCount();
+    if (count == 0) {
+        moves[0] = _moveOrder[0];
+        return board.pieceCount() == 0 ? 1 : 0;
+    }
+    // a few dozen moves at most, insertion sort on the precomputed rank
+    for (int i = 0; i < count; i++) {
+        const int cell = board.candidate(i);
+        int j = i;
+        for (; j > 0 && _moveRank[moves[j - 1]] > _moveRank[cell]; j--) {
+            moves[j] = moves[j - 1];
+        }
+        moves[j] = cell;
+    }
+    return count;
+}
+
+bool KInARowSearch::outOfTime(Worker &worker)
+{
+    if ((worker.nodes % CLOCK_CHECK_INTERVAL) == 0) {
+        if ((_canAbort && Clock::now() >= _deadline) || (_stop && _stop->load(std::memory_order_relaxed))) {
+            _aborted.store(true, std::memory_order_relaxed);
+        }
+    }
+    return _aborted.load(std::memory_order_relaxed);
+}
+
+//
+// iterative deepening driver
+//
+int KInARowSearch::findBestMove(const KInARowBoard &board, int player, int timeBudgetMs)
+{
+    const Clock::time_point start = Clock::now();
+    _nodeCount = 0;
+    _depthReached = 0;
+    _elapsedMs = 0;
+    _canAbort = false;
+    _aborted = false;
+    _deadline = start + std::chrono::milliseconds(timeBudgetMs);
+    if (board.winner() >= 0 || board.full()) {
+        return -1;
+    }
+
+    const int maxDepth = board.cellCount() - board.pieceCount();
+    buildMoveOrder(board);
+    for (Worker &worker : _workers) {
+        worker.board = board;
+        worker.moveStack.resize((size_t)board.cellCount() * (maxDepth + 1));
+        worker.nodes = 0;
+    }
+    _rootMoves.resize(board.cellCount());
+    _rootMoves.resize(orderMoves(board, _rootMoves.data()));
+
+    int bestMove = -1;
+    for (int depth = 1; depth <= maxDepth; depth++) {
+        int score = 0;
+        int move = searchRoot(depth, player, &score);
+        if (_aborted) {
+            // cancelled before the first iteration finished, there is nothing to play
+            if (_stop && _stop->load(std::memory_order_relaxed)) {
+                bestMove = -1;
+            }
+            break;
+        }
+        bestMove = move;
+        _depthReached = depth;
+        _canAbort = true;
+
+        // the next iteration starts with this move
+        auto found = std::find(_rootMoves.begin(), _rootMoves.end(), move);
+        std::rotate(_rootMoves.begin(), found, found + 1);
+
+        // a forced win or loss won't change with a deeper search
+        if (std::abs(score) >= kWinScore - maxDepth) {
+            break;
+        }
+    }
+
+    for (Worker &worker : _workers) {
+        _nodeCount += worker.nodes;
+    }
+    _elapsedMs = (int)std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+    return bestMove;
+}
+
+//
+// one iteration at the root: the first move on this thread with a full window,
+// then the rest split across every worker
+//
+int KInARowSearch::searchRoot(int depth, int player, int *bestScore)
+{
+    Worker &first = _workers[0];
+    first.nodes++;
+    int move = _rootMoves[0];
+    first.board.place(move, player);
+    int score = -negamax(first, 1, depth, -kInfiniteScore, kInfiniteScore, 1 - player);
+    first.board.remove(move);
+    if (_aborted) {
+        return -1;
+    }
+
+    _rootBestMove = move;
+    _rootBestScore = score;
+    _rootAlpha = score;
+    _nextRootMove = 1;
+
+    if (_rootMoves.size() > 1) {
+        const bool split = !_helpers.empty();
+        if (split) {
+            {
+                std::lock_guard<std::mutex> lock(_poolLock);
+                _splitDepth = depth;
+                _splitPlayer = player;
+                _busyHelpers = (int)_helpers.size();
+                _generation++;
+            }
+            _poolWake.notify_all();
+        }
+        searchRootMoves(first, depth, player);
+        if (split) {
+            std::unique_lock<std::mutex> lock(_poolLock);
+            _poolDone.wait(lock, [this] { return _busyHelpers == 0; });
+        }
+    }
+
+    *bestScore = _rootBestScore;
+    return _rootBestMove;
+}
+
+//
+// pull root moves until there are none left, each is searched against the
+// best score any thread has found so far
+//
+void KInARowSearch::searchRootMoves(Worker &worker, int depth, int player)
+{
+    for (;;) {
+        int i = _nextRootMove.fetch_add(1);
+        if (i >= (int)_rootMoves.size() || _aborted.load(std::memory_order_relaxed)) {
+            break;
+        }
+        int alpha = _rootAlpha.load();
+        int move = _rootMoves[i];
+
+        worker.board.place(move, player);
+        int score = -negamax(worker, 1, depth, -kInfiniteScore, -alpha, 1 - player);
+        worker.board.remove(move);
+
+        if (_aborted.load(std::memory_order_relaxed)) {
+            break;
+        }
+        // anything at or below alpha is only a bound, it can't beat the best move
+        if (score > alpha) {
+            std::lock_guard<std::mutex> lock(_rootLock);
+            if (score > _rootBestScore) {
+                _rootBestScore = score;
+                _rootBestMove = move;
+                _rootAlpha = score;
+            }
+        }
+    }
+}
+
+//
+// negamax with alpha-beta pruning, scores are from the side to move and
+// wins found closer to the root score higher
+//
+int KInARowSearch::negamax(Worker &worker, int depth, int maxDepth, int alpha, int beta, int player)
+{
+    KInARowBoard &board = worker.board;
+    worker.nodes++;
+    if (outOfTime(worker)) {
+        return 0;
+    }
+
+    // only the side that just moved can have won
+    if (board.hasWon(1 - player)) {
+        return -kWinScore + depth;
+    }
+    if (board.full()) {
+        return 0;
+    }
+    if (depth >= maxDepth) {
+        return std::clamp(board.evaluate(player), -kMaxEvaluation, kMaxEvaluation);
+    }
+
+    int *moves = &worker.moveStack[(size_t)depth * board.cellCount()];
+    int count = orderMoves(board, moves);
+
+    int maxScore = -kInfiniteScore;
+    for (int i = 0; i < count; i++) {
+        int cell = moves[i];
+
+        board.place(cell, player);
+        int score = -negamax(worker, depth + 1, maxDepth, -beta, -alpha, 1 - player);
+        board.remove(cell);
+
+        if (_aborted.load(std::memory_order_relaxed)) {
+            break;
+        }
+        if (score > maxScore) {
+            maxScore = score;
+        }
+        if (score > alpha) {
+            alpha = score;
+        }
+        if (alpha >= beta) {
+            break;
+        }
+    }
+
+    return maxScore;
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "KInARowBoard.h"
+
+//
+// alpha-beta search for m,n,k boards too big for the tic tac toe bitboard
+// only the board's candidate moves near existing pieces are searched. lines
+// finished in the search score as wins and losses, positions at the depth
+// limit get the board's incremental run evaluation. the search deepens one
+// ply at a time until the time budget runs out and plays the best move of the
+// last finished iteration.
+//
+// each iteration searches the previous best move first to get a bound, then
+// splits the remaining root moves across the worker threads, which share the
+// best score so far as their alpha. the helper threads live as long as the
+// search and sleep between iterations, so a shallow iteration costs a wakeup
+// rather than starting threads
+//
+class KInARowSearch
+{
+public:
+    static constexpr int kWinScore = 1000000;
+    static constexpr int kInfiniteScore = kWinScore + 1;
+    // evaluations are held below this so they never look like a forced win
+    static constexpr int kMaxEvaluation = kWinScore / 2;
+
+    KInARowSearch();
+    ~KInARowSearch();
+
+    // best cell for player to move, -1 if the board is full or already won
+    // the first iteration always finishes, later ones stop at the time budget
+    int         findBestMove(const KInARowBoard &board, int player, int timeBudgetMs);
+    // nodes visited by the last findBestMove, over all threads
+    int         nodeCount() const { return _nodeCount; }
+    // deepest iteration the last findBestMove finished
+    int         depthReached() const { return _depthReached; }
+    // wall clock time the last findBestMove took
+    int         elapsedMs() const { return _elapsedMs; }
+    // when *stop turns true the search gives up at once, even in the first iteration
+    void        setStopFlag(const std::atomic<bool> *stop) { _stop = stop; }
+    // threads used to split the root, 1 searches on the calling thread only
+    void        setThreadCount(int threads);
+    int         threadCount() const { return (int)_workers.size(); }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // everything one search thread writes to
+    struct Worker
+    {
+        KInARowBoard        board;
+        // per ply move lists
+        std::vector<int>    moveStack;
+        int                 nodes = 0;
+    };
+
+    int         searchRoot(int depth, int player, int *bestScore);
+    void        searchRootMoves(Worker &worker, int depth, int player);
+    int         negamax(Worker &worker, int depth, int maxDepth, int alpha, int beta, int player);
+    int         orderMoves(const KInARowBoard &board, int *moves);
+    void        buildMoveOrder(const KInARowBoard &board);
+    bool        outOfTime(Worker &worker);
+    void        helperThread(int index, int generation);
+    void        stopHelpers();
+
+    std::vector<Worker> _workers;
+    int                 _nodeCount;
+    int                 _depthReached;
+    int                 _elapsedMs;
+    bool                _canAbort;
+    std::atomic<bool>   _aborted;
+    Clock::time_point   _deadline;
+    const std::atomic<bool> *_stop;
+    // every cell, nearest the center first
+    std::vector<int>    _moveOrder;
+    // position of each cell in _moveOrder
+    std::vector<int>    _moveRank;
+    // legal root moves, best of the previous iteration first
+    std::vector<int>    _rootMoves;
+
+    // shared by the threads while the root is split
+    std::atomic<int>    _nextRootMove;
+    std::atomic<int>    _rootAlpha;
+    std::mutex          _rootLock;
+    int                 _rootBestMove;
+    int                 _rootBestScore;
+
+    // helper threads, one for each worker after the first
+    std::vector<std::thread> _helpers;
+    std::mutex          _poolLock;
+    // bumped for every root split, the helpers wake up when it changes
+    std::condition_variable _poolWake;
+    // the last helper to finish a split signals this
+    std::condition_variable _poolDone;
+    int                 _generation;
+    int                 _busyHelpers;
+    bool                _quit;
+    int                 _splitDepth;
+    int                 _splitPlayer;
+};
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+//
+// fixed size block allocator: memory comes from the heap a chunk at a time and
+// freed blocks go on a free list for the next allocation, so once a game has
+// warmed up creating and destroying pieces never touches the general heap.
+// chunks are only returned when the pool itself goes away.
+// not thread safe, pieces are only made and destroyed on the main thread
+//
+template <size_t BlockSize, size_t BlocksPerChunk = 256>
+class BlockPool
+{
+public:
+    BlockPool() : _free(nullptr) {}
+    BlockPool(const BlockPool &) = delete;
+    BlockPool &operator=(const BlockPool &) = delete;
+
+    void *allocate()
+    {
+        if (!_free) {
+            grow();
+        }
+        Block *block = _free;
+        _free = block->next;
+        return block;
+    }
+
+    void deallocate(void *pointer)
+    {
+        if (!pointer) {
+            return;
+        }
+        Block *block = static_cast<Block *>(pointer);
+        block->next = _free;
+        _free = block;
+    }
+
+    // blocks handed out or waiting on the free list
+    size_t capacity() const { return _chunks.size() * BlocksPerChunk; }
+
+private:
+    union Block
+    {
+        Block *next;
+        alignas(std::max_align_t) unsigned char storage[BlockSize];
+    };
+
+    void grow()
+    {
+        _chunks.push_back(std::make_unique<Block[]>(BlocksPerChunk));
+        Block *chunk = _chunks.back().get();
+        for (size_t i = 0; i < BlocksPerChunk; i++) {
+            chunk[i].next = _free;
+            _free = &chunk[i];
+        }
+    }
+
+    std::vector<std::unique_ptr<Block[]>> _chunks;
+    Block *_free;
+};
@@ -0,0 +1,96 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "KInARowBoard.h"
+
+//
+// fixed size board state, 2 bits a cell: 0 empty, 1 player 0, 2 player 1
+// big enough for the largest KInARowBoard, copied, compared and hashed as a
+// few machine words with no allocation. state strings ("0", "1", "2" per cell)
+// are converted to and from this at the edges for sync and persistence
+//
+struct PackedBoardState
+{
+    static constexpr int kMaxCells = KInARowBoard::kMaxDimension * KInARowBoard::kMaxDimension;
+    static constexpr int kCellsPerWord = 32;
+    static constexpr int kWords = kMaxCells / kCellsPerWord;
+
+    uint64_t    words[kWords];
+    int         cellCount;
+
+    PackedBoardState() : words{}, cellCount(0) {}
+
+    // empty board of count cells
+    void clear(int count)
+    {
+        for (uint64_t &word : words) {
+            word = 0;
+        }
+        cellCount = count;
+    }
+
+    int get(int cell) const
+    {
+        return (int)((words[cell / kCellsPerWord] >> ((cell % kCellsPerWord) * 2)) & 3);
+    }
+
+    void set(int cell, int value)
+    {
+        const int shift = (cell % kCellsPerWord) * 2;
+        uint64_t &word = words[cell / kCellsPerWord];
+        word = (word & ~((uint64_t)3 << shift)) | ((uint64_t)(value & 3) << shift);
+    }
+
+    // only the words the board uses take part, the rest are always zero
+    int usedWords() const { return (cellCount + kCellsPerWord - 1) / kCellsPerWord; }
+
+    bool operator==(const PackedBoardState &other) const
+    {
+        if (cellCount != other.cellCount) {
+            return false;
+        }
+        for (int i = 0; i < usedWords(); i++) {
+            if (words[i] != other.words[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+    bool operator!=(const PackedBoardState &other) const { return !(*this == other); }
+
+    size_t hash() const
+    {
+        // FNV-1a over the used words, mixed a word at a time
+        uint64_t h = 0xcbf29ce484222325ull ^ (uint64_t)cellCount;
+        for (int i = 0; i < usedWords(); i++) {
+            h = (h ^ words[i]) * 0x100000001b3ull;
+            h ^= h >> 29;
+        }
+        return (size_t)h;
+    }
+
+    // text adapter, writes into text without reallocating once it has the capacity
+    void toString(std::string &text) const
+    {
+        text.resize(cellCount);
+        for (int cell = 0; cell < cellCount; cell++) {
+            text[cell] = (char)('0' + get(cell));
+        }
+    }
+
+    // false if text has a character other than 0, 1 or 2
+    bool fromString(const std::string &text)
+    {
+        clear((int)std::min(text.size(), (size_t)kMaxCells));
+        for (int cell = 0; cell < cellCount; cell++) {
+            const int value = text[cell] - '0';
+            if (value < 0 || value > 2) {
+                return false;
+            }
+            set(cell, value);
+        }
+        return true;
+    }
+};
@@ -0,0 +1,125 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+Profiler &Profiler::shared()
+{
+    static Profiler profiler;
+    return profiler;
+}
+
+Profiler::Profiler() :
+    _epoch(std::chrono::steady_clock::now()),
+    _tracing(false)
+{
+}
+
+int64_t Profiler::now() const
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _epoch).count();
+}
+
+Profiler::Section *Profiler::section(const char *name)
+{
+    // a handful of sections, a linear search beats hashing the name
+    for (Section &section : _sections) {
+        if (section.name == name || strcmp(section.name, name) == 0) {
+            return &section;
+        }
+    }
+    _sections.push_back(Section{});
+    Section &section = _sections.back();
+    section.name = name;
+    return &section;
+}
+
+uint32_t Profiler::threadNumber()
+{
+    static std::atomic<uint32_t> threadCount(0);
+    thread_local uint32_t number = threadCount++;
+    return number;
+}
+
+void Profiler::record(const char *name, int64_t start, int64_t duration)
+{
+    const uint32_t thread = threadNumber();
+    std::lock_guard<std::mutex> lock(_mutex);
+    Section *s = section(name);
+    s->samples[s->next] = duration / 1000.0f;
+    s->next = (s->next + 1) % kHistory;
+    s->count = std::min(s->count + 1, kHistory);
+
+    if (_tracing && _trace.size() < kMaxTraceEvents) {
+        _trace.push_back(TraceEvent{ s->name, start, duration, thread });
+    }
+}
+
+void Profiler::stats(std::vector<ProfileStats> &out)
+{
+    out.clear();
+    float sorted[kHistory];
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (const Section &section : _sections) {
+        const int count = section.count;
+        std::copy(section.samples, section.samples + count, sorted);
+        std::sort(sorted, sorted + count);
+        // nearest rank percentile
+        auto percentile = [&](int p) { return sorted[std::max((count * p + 99) / 100 - 1, 0)]; };
+        out.push_back(ProfileStats{ section.name, count, percentile(50), percentile(95), percentile(99), sorted[count - 1] });
+    }
+}
+
+void Profiler::history(const char *name, std::vector<float> &out)
+{
+    out.clear();
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (const Section &section : _sections) {
+        if (strcmp(section.name, name) == 0) {
+            // the oldest sample sits where the next one goes once the ring is full
+            const int oldest = (section.count == kHistory) ? section.next : 0;
+            for (int i = 0; i < section.count; i++) {
+                out.push_back(section.samples[(oldest + i) % kHistory]);
+            }
+            return;
+        }
+    }
+}
+
+void Profiler::startTrace()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _trace.clear();
+    _tracing = true;
+}
+
+size_t Profiler::traceEventCount()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _trace.size();
+}
+
+bool Profiler::stopTrace(const std::string &path)
+{
+    std::vector<TraceEvent> trace;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _tracing = false;
+        trace.swap(_trace);
+    }
+
+    FILE *file = fopen(path.c_str(), "w");
+    if (!file) {
+        return false;
+    }
+    // complete events ("ph":"X"), timestamps and durations in microseconds
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for (size_t i = 0; i < trace.size(); i++) {
+        const TraceEvent &event = trace[i];
+        fprintf(file, "{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%lld,\"dur\":%lld,\"pid\":1,\"tid\":%u}%s\n",
+                event.name, (long long)event.start, (long long)event.duration, event.thread,
+                (i + 1 < trace.size()) ? "," : "");
+    }
+    fprintf(file, "]}\n");
+    return fclose(file) == 0;
+}
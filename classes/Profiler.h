@@ -0,0 +1,105 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+//
+// timings for a game's hot paths, in milliseconds
+// p50/p95/p99 and max are over the last Profiler::kHistory samples
+//
+struct ProfileStats
+{
+    const char  *name;
+    int         count;
+    float       p50;
+    float       p95;
+    float       p99;
+    float       max;
+};
+
+//
+// process wide profiler. PROFILE_SCOPE("name") times the rest of the enclosing block
+// and files the sample under name, a section is created the first time a name is seen.
+// every section keeps a ring of its latest samples for the percentiles and the histogram.
+// while a trace is running every sample is also kept as an event, stopTrace writes them
+// out as Chrome trace JSON for chrome://tracing or ui.perfetto.dev
+//
+class Profiler
+{
+public:
+    static constexpr int    kHistory = 240;
+    // about 32MB of events, a trace stops growing past this
+    static constexpr size_t kMaxTraceEvents = 1 << 20;
+
+    static Profiler &shared();
+
+    // microseconds since the profiler was created
+    int64_t     now() const;
+    // names are compared by value but kept by pointer, pass string literals
+    void        record(const char *name, int64_t start, int64_t duration);
+
+    // one entry per section, in the order the sections were first recorded
+    void        stats(std::vector<ProfileStats> &out);
+    // a section's history oldest first, empty if nothing was recorded under name
+    void        history(const char *name, std::vector<float> &out);
+
+    void        startTrace();
+    bool        tracing() const { return _tracing; }
+    size_t      traceEventCount();
+    // end the trace and write it to path, false if the file couldn't be written
+    bool        stopTrace(const std::string &path);
+
+private:
+    Profiler();
+
+    struct Section
+    {
+        const char  *name;
+        float       samples[kHistory];
+        int         next;
+        int         count;
+    };
+
+    struct TraceEvent
+    {
+        const char  *name;
+        int64_t     start;
+        int64_t     duration;
+        uint32_t    thread;
+    };
+
+    // called with _mutex held
+    Section     *section(const char *name);
+    // small stable number for the calling thread, trace viewers show one row per thread
+    static uint32_t threadNumber();
+
+    std::chrono::steady_clock::time_point   _epoch;
+    std::mutex                  _mutex;
+    std::vector<Section>        _sections;
+    std::atomic<bool>           _tracing;
+    std::vector<TraceEvent>     _trace;
+};
+
+//
+// times its own lifetime
+//
+class ProfileScope
+{
+public:
+    explicit ProfileScope(const char *name) : _name(name), _start(Profiler::shared().now()) {}
+    ~ProfileScope() { Profiler::shared().record(_name, _start, Profiler::shared().now() - _start); }
+
+    ProfileScope(const ProfileScope &) = delete;
+    ProfileScope &operator=(const ProfileScope &) = delete;
+
+private:
+    const char  *_name;
+    int64_t     _start;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
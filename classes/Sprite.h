@@ -1,5 +1,7 @@
 #pragma once
+#include <cstdint>
 #include "Entity.h"
+#include "TextureCache.h"
 #include "../imgui/imgui.h"
 
 class Sprite : public Entity
@@ -16,11 +18,14 @@ public:
         _scale(1),
         _color(1, 1, 1, 1),
         _localZOrder(0),
+        _texture(nullptr),
         _highlighted(false)
         { 
             _entityType = EntitySprite;
         };
-    ~Sprite() { if (_retainCount > 0) release(); }
+    Sprite(const Sprite &other);
+    Sprite &operator=(const Sprite &other);
+    ~Sprite();
     
     // set the texture to use for this sprite
     void setPosition(float x, float y)
@@ -32,6 +37,7 @@ public:
         _location = point;
     }
     const ImVec2 &getPosition() { return _location; }
+    const ImVec2 &getSize() { return _size; }
 
     void setSize(float x, float y)
     {
@@ -54,14 +60,20 @@ public:
     float getRotation() { return _rotation; }
     // moveTo
     void moveTo(const ImVec2 &point) { _location = point; }
-    // draw the sprite
-    void paintSprite()
+    // add the sprite to a draw list as one textured quad, origin is where the
+    // window's 0,0 lands on screen. sprites sharing the atlas texture end up in the
+    // same draw command, and the highlight is only a change of vertex color
+    void paintSprite(ImDrawList *drawList, const ImVec2 &origin)
     {
-        if (_size.x > 0.0f && _size.y > 0.0f) 
+        if (_texture && _size.x > 0.0f && _size.y > 0.0f) 
         {
-            ImGui::SetCursorPos(_location);
-            ImVec4 highlight = _highlighted ? ImVec4(1, 1, 0, 1) : ImVec4(0, 0, 0, 0);
-            ImGui::Image((void*)(intptr_t)_texture, _size, ImVec2(0, 0), ImVec2(1, 1), _color, highlight);
+            ImVec4 tint = _color;
+            if (_highlighted) {
+                tint.z *= 0.35f;
+            }
+            const ImVec2 topLeft(origin.x + _location.x, origin.y + _location.y);
+            const ImVec2 bottomRight(topLeft.x + _size.x, topLeft.y + _size.y);
+            drawList->AddImage(_texture->id, topLeft, bottomRight, _texture->uv0, _texture->uv1, ImGui::ColorConvertFloat4ToU32(tint));
         }
     }
 	// is the mouse over this position?
@@ -95,10 +107,8 @@ private:
     ImVec4  _color;
     // the local Z order
     int _localZOrder;
-    // the texture we're going to draw
-    ImTextureID _texture;
+    // the texture we're going to draw, shared through the TextureCache
+    Texture *_texture;
     // currently highlighted
    	bool	_highlighted;
-    // private platform specific texture loading
-    ImTextureID _loadTextureFromMemory(const unsigned char *image_data, int image_width, int image_height);
 };
@@ -0,0 +1,180 @@
+#include "TextureAtlas.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+// imgui_draw.cpp keeps its copy of the packer static, this one is ours
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-function"
+#endif
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "../imgui/imstb_rectpack.h"
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+// bundle layout, all little endian: header, entryCount entries, pixels at pixelOffset
+static const char BUNDLE_MAGIC[4] = { 'T', 'T', 'A', 'B' };
+const uint32_t BUNDLE_VERSION = 1;
+const int BUNDLE_NAME_LENGTH = 48;
+
+struct BundleHeader
+{
+    char        magic[4];
+    uint32_t    version;
+    uint32_t    width;
+    uint32_t    height;
+    uint32_t    entryCount;
+    uint32_t    reserved;
+    uint64_t    pixelOffset;
+};
+
+struct BundleEntry
+{
+    char        name[BUNDLE_NAME_LENGTH];
+    int32_t     x;
+    int32_t     y;
+    int32_t     width;
+    int32_t     height;
+};
+
+bool TextureAtlas::pack(const std::vector<AtlasImage> &images)
+{
+    width = 0;
+    height = 0;
+    entries.clear();
+    pixels.clear();
+    if (images.empty()) {
+        return false;
+    }
+
+    // smallest power of two square everything fits in
+    std::vector<stbrp_rect> rects(images.size());
+    int atlasSize = 64;
+    for (;; atlasSize *= 2) {
+        if (atlasSize > kMaxSize) {
+            std::cout << "Texture atlas doesn't fit in " << kMaxSize << " pixels" << std::endl;
+            return false;
+        }
+        for (size_t i = 0; i < images.size(); i++) {
+            rects[i] = {};
+            rects[i].id = (int)i;
+            rects[i].w = images[i].width + kPadding * 2;
+            rects[i].h = images[i].height + kPadding * 2;
+        }
+        stbrp_context context;
+        std::vector<stbrp_node> nodes(atlasSize);
+        stbrp_init_target(&context, atlasSize, atlasSize, nodes.data(), (int)nodes.size());
+        if (stbrp_pack_rects(&context, rects.data(), (int)rects.size())) {
+            break;
+        }
+    }
+
+    width = atlasSize;
+    height = 1;
+    for (const stbrp_rect &rect : rects) {
+        while (height < rect.y + rect.h) {
+            height *= 2;
+        }
+    }
+
+    // copy each image in, clamping to its edge one pixel into the padding
+    // so linear filtering never picks up a neighbour
+    pixels.assign((size_t)width * height * 4, 0);
+    for (const stbrp_rect &rect : rects) {
+        const AtlasImage &image = images[rect.id];
+        const int left = rect.x + kPadding;
+        const int top = rect.y + kPadding;
+        for (int y = -1; y <= image.height; y++) {
+            const int sourceY = std::clamp(y, 0, image.height - 1);
+            for (int x = -1; x <= image.width; x++) {
+                const int sourceX = std::clamp(x, 0, image.width - 1);
+                const size_t source = ((size_t)sourceY * image.width + sourceX) * 4;
+                const size_t target = ((size_t)(top + y) * width + (left + x)) * 4;
+                memcpy(&pixels[target], &image.pixels[source], 4);
+            }
+        }
+        entries.push_back({ image.name, left, top, image.width, image.height });
+    }
+    return true;
+}
+
+bool TextureAtlas::save(const std::string &path) const
+{
+    FILE *file = fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    BundleHeader header = {};
+    memcpy(header.magic, BUNDLE_MAGIC, sizeof(header.magic));
+    header.version = BUNDLE_VERSION;
+    header.width = (uint32_t)width;
+    header.height = (uint32_t)height;
+    header.entryCount = (uint32_t)entries.size();
+    // pixels start on a 16 byte boundary so the blob can be mapped and uploaded in place
+    header.pixelOffset = (sizeof(BundleHeader) + sizeof(BundleEntry) * entries.size() + 15) & ~(uint64_t)15;
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    for (const AtlasEntry &entry : entries) {
+        BundleEntry record = {};
+        strncpy(record.name, entry.name.c_str(), BUNDLE_NAME_LENGTH - 1);
+        record.x = entry.x;
+        record.y = entry.y;
+        record.width = entry.width;
+        record.height = entry.height;
+        ok = ok && fwrite(&record, sizeof(record), 1, file) == 1;
+    }
+    const char zeros[16] = {};
+    const size_t written = sizeof(BundleHeader) + sizeof(BundleEntry) * entries.size();
+    ok = ok && fwrite(zeros, 1, header.pixelOffset - written, file) == header.pixelOffset - written;
+    ok = ok && fwrite(pixels.data(), 1, pixels.size(), file) == pixels.size();
+    return (fclose(file) == 0) && ok;
+}
+
+bool TextureAtlas::load(const std::string &path)
+{
+    width = 0;
+    height = 0;
+    entries.clear();
+    pixels.clear();
+
+    FILE *file = fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    BundleHeader header;
+    bool ok = fread(&header, sizeof(header), 1, file) == 1
+           && memcmp(header.magic, BUNDLE_MAGIC, sizeof(header.magic)) == 0
+           && header.version == BUNDLE_VERSION
+           && header.width > 0 && header.width <= (uint32_t)kMaxSize
+           && header.height > 0 && header.height <= (uint32_t)kMaxSize;
+    for (uint32_t i = 0; ok && i < header.entryCount; i++) {
+        BundleEntry record;
+        ok = fread(&record, sizeof(record), 1, file) == 1;
+        record.name[BUNDLE_NAME_LENGTH - 1] = 0;
+        // every rectangle has to lie inside the atlas
+        ok = ok && record.x >= 0 && record.y >= 0 && record.width > 0 && record.height > 0
+                && record.x + record.width <= (int)header.width && record.y + record.height <= (int)header.height;
+        if (ok) {
+            entries.push_back({ record.name, record.x, record.y, record.width, record.height });
+        }
+    }
+    if (ok) {
+        pixels.resize((size_t)header.width * header.height * 4);
+        ok = fseek(file, (long)header.pixelOffset, SEEK_SET) == 0
+          && fread(pixels.data(), 1, pixels.size(), file) == pixels.size();
+    }
+    fclose(file);
+    if (!ok) {
+        entries.clear();
+        pixels.clear();
+        return false;
+    }
+    width = (int)header.width;
+    height = (int)header.height;
+    return true;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <string>
+#include <vector>
+
+//
+// decoded rgba image waiting to be packed
+//
+struct AtlasImage
+{
+    std::string                 name;
+    int                         width;
+    int                         height;
+    std::vector<unsigned char>  pixels;
+};
+
+//
+// where an image ended up in the atlas, in pixels
+//
+struct AtlasEntry
+{
+    std::string name;
+    int         x;
+    int         y;
+    int         width;
+    int         height;
+};
+
+//
+// every sprite image packed into one rgba image
+//
+// the bundle_assets tool packs resources at build time and saves the result as
+// one blob: a small header, the entries, then the raw pixels. loading that is a
+// single read straight into the pixel buffer, with no png decoding at startup
+//
+struct TextureAtlas
+{
+    static constexpr int kPadding = 2;
+    static constexpr int kMaxSize = 4096;
+
+    int                         width = 0;
+    int                         height = 0;
+    std::vector<AtlasEntry>     entries;
+    std::vector<unsigned char>  pixels;     // width * height * 4 bytes
+
+    // pack the images into the smallest power of two square they fit in,
+    // then trim the unused rows off the bottom
+    bool        pack(const std::vector<AtlasImage> &images);
+    // write / read the bundle blob
+    bool        save(const std::string &path) const;
+    bool        load(const std::string &path);
+};
@@ -0,0 +1,232 @@
+#include "TextureCache.h"
+#include "TextureAtlas.h"
+#include <iostream>
+#include <filesystem>
+
+#ifndef HEADLESS
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#endif
+
+// written by the bundle_assets tool at build time, next to the executable
+const char ASSET_BUNDLE[] = "resources.bundle";
+
+TextureCache &TextureCache::shared()
+{
+    static TextureCache cache;
+    return cache;
+}
+
+Texture *TextureCache::acquire(const std::string &name)
+{
+    auto found = _textures.find(name);
+    if (found != _textures.end()) {
+        found->second.refCount++;
+        return &found->second;
+    }
+
+    Texture texture = { name, 0, ImVec2(0, 0), 1, ImVec2(0, 0), ImVec2(1, 1) };
+#ifndef HEADLESS
+    int image_width = 0;
+    int image_height = 0;
+    std::vector<unsigned char> image_data = decode(name, image_width, image_height);
+    if (image_data.empty()) {
+        return nullptr;
+    }
+    texture.id = upload(image_data.data(), image_width, image_height);
+    if (texture.id == 0) {
+        return nullptr;
+    }
+    texture.size = ImVec2((float)image_width, (float)image_height);
+#endif
+    // headless builds keep a placeholder entry so sprites still count their references
+    return &_textures.emplace(name, texture).first->second;
+}
+
+std::vector<unsigned char> TextureCache::decode(const std::string &name, int &width, int &height)
+{
+    std::vector<unsigned char> pixels;
+#ifndef HEADLESS
+    // Load from file
+    std::filesystem::path resourcePath = std::filesystem::path("resources") / name;
+    std::string newFilename = resourcePath.string();
+    unsigned char* image_data = stbi_load(newFilename.c_str(), &width, &height, NULL, 4);
+    if (image_data == NULL) {
+        std::cout << "Failed to load texture: " << newFilename << std::endl;
+        return pixels;
+    }
+    pixels.assign(image_data, image_data + (size_t)width * height * 4);
+    stbi_image_free(image_data);
+#endif
+    return pixels;
+}
+
+bool TextureCache::buildAtlas()
+{
+#ifdef HEADLESS
+    return false;
+#else
+    if (_atlas != 0) {
+        return true;
+    }
+
+    // the prebuilt bundle is one read, decoding and packing the pngs is the fallback
+    TextureAtlas atlas;
+    if (!atlas.load(ASSET_BUNDLE)) {
+        std::vector<AtlasImage> images;
+        std::error_code error;
+        for (const auto &entry : std::filesystem::directory_iterator("resources", error)) {
+            if (entry.path().extension() != ".png") {
+                continue;
+            }
+            AtlasImage image = { entry.path().filename().string(), 0, 0, {} };
+            image.pixels = decode(image.name, image.width, image.height);
+            if (!image.pixels.empty()) {
+                images.push_back(std::move(image));
+            }
+        }
+        if (!atlas.pack(images)) {
+            return false;
+        }
+    }
+    _atlas = upload(atlas.pixels.data(), atlas.width, atlas.height);
+    if (_atlas == 0) {
+        return false;
+    }
+
+    // the atlas holds the first reference, so these are never freed on their own
+    // anything already handed out as its own texture stays that way
+    const ImVec2 scale(1.0f / atlas.width, 1.0f / atlas.height);
+    for (const AtlasEntry &entry : atlas.entries) {
+        const float x = (float)entry.x;
+        const float y = (float)entry.y;
+        Texture texture = { entry.name, _atlas, ImVec2((float)entry.width, (float)entry.height), 1,
+                            ImVec2(x * scale.x, y * scale.y), ImVec2((x + entry.width) * scale.x, (y + entry.height) * scale.y) };
+        _textures.emplace(entry.name, texture);
+    }
+    return true;
+#endif
+}
+
+void TextureCache::retain(Texture *texture)
+{
+    if (texture) {
+        texture->refCount++;
+    }
+}
+
+void TextureCache::release(Texture *texture)
+{
+    if (!texture || --texture->refCount > 0) {
+        return;
+    }
+    destroy(texture->id);
+    _textures.erase(texture->name);
+}
+
+#if defined(HEADLESS)
+
+// no graphics device, nothing is ever uploaded
+
+ImTextureID TextureCache::upload(const unsigned char *pixels, int width, int height)
+{
+    return 0;
+}
+
+void TextureCache::destroy(ImTextureID id)
+{
+}
+
+#elif !defined(_WIN32)
+#include "../imgui/imgui_impl_opengl3_loader.h"
+
+// Simple helper function to load an image into a OpenGL texture with common settings
+ImTextureID TextureCache::upload(const unsigned char *image_data, int image_width, int image_height)
+{
+    // Create a OpenGL texture identifier
+    GLuint image_texture;
+    glGenTextures(1, &image_texture);
+    glBindTexture(GL_TEXTURE_2D, image_texture);
+
+    // Setup filtering parameters for display
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    // Upload pixels into texture
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image_width, image_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image_data);
+
+    return static_cast<ImTextureID>(image_texture);
+}
+
+void TextureCache::destroy(ImTextureID id)
+{
+    GLuint image_texture = (GLuint)(intptr_t)id;
+    glDeleteTextures(1, &image_texture);
+}
+
+#else
+
+// DirectX
+#include <stdio.h>
+#include <d3d11.h>
+#include <d3dcompiler.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "d3dcompiler") // Automatically link with d3dcompiler.lib as we are using D3DCompile() below.
+#endif
+
+ImTextureID TextureCache::upload(const unsigned char *image_data, int image_width, int image_height)
+{
+    // Create texture
+    D3D11_TEXTURE2D_DESC desc;
+    ZeroMemory(&desc, sizeof(desc));
+    desc.Width = image_width;
+    desc.Height = image_height;
+    desc.MipLevels = 1;
+    desc.ArraySize = 1;
+    desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    desc.SampleDesc.Count = 1;
+    desc.Usage = D3D11_USAGE_DEFAULT;
+    desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    desc.CPUAccessFlags = 0;
+
+    ID3D11Texture2D *pTexture = NULL;
+    D3D11_SUBRESOURCE_DATA subResource;
+    subResource.pSysMem = image_data;
+    subResource.SysMemPitch = desc.Width * 4;
+    subResource.SysMemSlicePitch = 0;
+
+    // You need to have a valid ID3D11Device* available as g_pd3dDevice
+    extern ID3D11Device* g_pd3dDevice; // Add this line if g_pd3dDevice is defined elsewhere
+
+    HRESULT hr = g_pd3dDevice->CreateTexture2D(&desc, &subResource, &pTexture);
+    if (FAILED(hr) || !pTexture) {
+        return 0;
+    }
+
+    // Create texture view
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc;
+    ZeroMemory(&srvDesc, sizeof(srvDesc));
+    srvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+    srvDesc.Texture2D.MipLevels = desc.MipLevels;
+    srvDesc.Texture2D.MostDetailedMip = 0;
+
+    ID3D11ShaderResourceView* shaderResourceView = nullptr;
+    hr = g_pd3dDevice->CreateShaderResourceView(pTexture, &srvDesc, &shaderResourceView);
+    pTexture->Release();
+
+    if (FAILED(hr) || !shaderResourceView) {
+
+        return 0;
+    }
+    return reinterpret_cast<ImTextureID>(shaderResourceView);
+}
+
+void TextureCache::destroy(ImTextureID id)
+{
+    ID3D11ShaderResourceView* shaderResourceView = reinterpret_cast<ID3D11ShaderResourceView*>(id);
+    if (shaderResourceView) {
+        shaderResourceView->Release();
+    }
+}
+#endif
@@ -0,0 +1,62 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../imgui/imgui.h"
+
+//
+// one decoded, uploaded image shared by every sprite drawn with it
+// images packed into the atlas share its id and draw from their uv rectangle
+//
+struct Texture
+{
+    std::string name;
+    ImTextureID id;
+    ImVec2      size;
+    int         refCount;
+    ImVec2      uv0;
+    ImVec2      uv1;
+};
+
+//
+// process wide cache of textures keyed by resource name
+// the first acquire decodes the png and uploads it, later ones hand out the
+// same texture. sprites hold one reference each and give it back when they are
+// destroyed, the texture is freed when the last one goes away
+//
+// buildAtlas puts every sprite image into one texture up front, so a whole
+// board draws from a single texture and ImGui can batch it into one draw call.
+// the atlas comes from the prebuilt resources.bundle when there is one.
+// atlas entries are pinned and live as long as the atlas does
+//
+class TextureCache
+{
+public:
+    static TextureCache &shared();
+
+    // texture for resources/name with one more reference, nullptr if it can't be loaded
+    Texture     *acquire(const std::string &name);
+    // add a reference to a texture already in the cache
+    void        retain(Texture *texture);
+    // drop a reference, the last one frees the texture
+    void        release(Texture *texture);
+    // textures currently loaded
+    size_t      count() const { return _textures.size(); }
+
+    // load or pack the atlas and upload it, call once the graphics device is up
+    bool        buildAtlas();
+    ImTextureID atlas() const { return _atlas; }
+
+private:
+    TextureCache() = default;
+
+    // platform specific upload and free
+    static ImTextureID  upload(const unsigned char *pixels, int width, int height);
+    static void         destroy(ImTextureID id);
+    // rgba pixels of resources/name, empty if it can't be read
+    static std::vector<unsigned char> decode(const std::string &name, int &width, int &height);
+
+    // node based, so Texture pointers stay valid while other entries come and go
+    std::unordered_map<std::string, Texture> _textures;
+    ImTextureID _atlas = 0;
+};
@@ -0,0 +1,251 @@
+#include "ThreatSearch.h"
+#include <algorithm>
+
+// how many nodes go by between looks at the clock
+const int CLOCK_CHECK_INTERVAL = 1024;
+// plies a search can stack up: a VCF under every level of a VCT
+const int MAX_PLY = ThreatSearch::kMaxVCFDepth + ThreatSearch::kMaxVCTDepth + 2;
+// kept apart in the table: VCF and VCT results for either attacker
+const uint64_t TABLE_SALT[2][2] = {
+    { 0x243F6A8885A308D3ULL, 0x13198A2E03707344ULL },
+    { 0xA4093822299F31D0ULL, 0x082EFA98EC4E6C89ULL }
+};
+
+ThreatSearch::ThreatSearch()
+{
+    _nodeCount = 0;
+    _threatDepth = 0;
+    _elapsedMs = 0;
+    _aborted = false;
+    _stop = nullptr;
+    _tableWidth = 0;
+    _tableHeight = 0;
+    _tableWinLength = 0;
+}
+
+bool ThreatSearch::outOfTime()
+{
+    if ((_nodeCount % CLOCK_CHECK_INTERVAL) == 0) {
+        if (Clock::now() >= _deadline || (_stop && _stop->load(std::memory_order_relaxed))) {
+            _aborted = true;
+        }
+    }
+    return _aborted;
+}
+
+ThreatSearch::Entry *ThreatSearch::probe(uint64_t key)
+{
+    Entry &entry = _table[key & (kTableSize - 1)];
+    return (entry.key == key && entry.result != kUnknown) ? &entry : nullptr;
+}
+
+void ThreatSearch::store(uint64_t key, Result result, int depth, int move)
+{
+    Entry &entry = _table[key & (kTableSize - 1)];
+    entry.key = key;
+    entry.move = (int16_t)move;
+    entry.depth = (int8_t)depth;
+    entry.result = result;
+}
+
+int ThreatSearch::gatherMoves(int attacker, int length, int ply, int *&moves)
+{
+    moves = &_moveStack[(size_t)(2 * ply) * _board.cellCount()];
+    int count = 0;
+    for (int i = 0; i < _board.candidateCount(); i++) {
+        const int cell = _board.candidate(i);
+        for (int run = _board.winLength() - 1; run >= length; run--) {
+            if (_board.makesRun(cell, attacker, run)) {
+                moves[count++] = cell;
+                break;
+            }
+        }
+    }
+    return count;
+}
+
+int ThreatSearch::gatherReplies(int ply, int *&moves)
+{
+    moves = &_moveStack[(size_t)(2 * ply + 1) * _board.cellCount()];
+    int count = 0;
+    for (int i = 0; i < _board.candidateCount(); i++) {
+        moves[count++] = _board.candidate(i);
+    }
+    for (int cell = 0; cell < _board.cellCount(); cell++) {
+        if (_board.empty(cell) && !_board.isCandidate(cell)) {
+            moves[count++] = cell;
+        }
+    }
+    return count;
+}
+
+int ThreatSearch::findForcedWin(const KInARowBoard &board, int player, int timeBudgetMs)
+{
+    const Clock::time_point start = Clock::now();
+    _deadline = start + std::chrono::milliseconds(timeBudgetMs);
+    _nodeCount = 0;
+    _threatDepth = 0;
+    _elapsedMs = 0;
+    _aborted = false;
+    if (board.winner() >= 0 || board.full()) {
+        return -1;
+    }
+
+    _board = board;
+    _moveStack.resize((size_t)(2 * MAX_PLY) * board.cellCount());
+    _winningCells.resize(board.cellCount());
+    // the keys only cover the cells, so the table is kept from move to move
+    // but nothing is carried over to a board of another shape
+    if (_table.empty() || board.width() != _tableWidth || board.height() != _tableHeight || board.winLength() != _tableWinLength) {
+        _table.assign(kTableSize, Entry{ 0, -1, 0, kUnknown });
+        _tableWidth = board.width();
+        _tableHeight = board.height();
+        _tableWinLength = board.winLength();
+    }
+
+    int move = -1;
+    if (!vcf(player, kMaxVCFDepth, 0, &move)) {
+        move = -1;
+        // threes only mean something when a line takes a few pieces
+        for (int depth = 1; depth <= kMaxVCTDepth && _board.winLength() >= 4 && !_aborted; depth++) {
+            if (vct(player, depth, 0, &move)) {
+                _threatDepth = depth;
+                break;
+            }
+            move = -1;
+        }
+    }
+
+    _elapsedMs = (int)std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+    return _aborted && _stop && _stop->load() ? -1 : move;
+}
+
+//
+// a chain of fours for attacker, the defender's only reply to each is the block
+//
+bool ThreatSearch::vcf(int attacker, int depth, int ply, int *move)
+{
+    _nodeCount++;
+    if (outOfTime()) {
+        return false;
+    }
+    const int defender = 1 - attacker;
+    int *cells = _winningCells.data();
+    if (_board.hasThreat(attacker)) {
+        _board.winningCells(attacker, cells);
+        *move = cells[0];
+        return true;
+    }
+    // the defender would win before the next four lands
+    if (_board.hasThreat(defender) || depth == 0) {
+        return false;
+    }
+
+    const uint64_t key = _board.hash() ^ TABLE_SALT[0][attacker];
+    if (Entry *entry = probe(key)) {
+        if (entry->result == kWin) {
+            *move = entry->move;
+            return true;
+        }
+        if (entry->depth >= depth) {
+            return false;
+        }
+    }
+
+    int *moves;
+    const int count = gatherMoves(attacker, _board.winLength() - 1, ply, moves);
+    for (int i = 0; i < count; i++) {
+        const int cell = moves[i];
+        _board.place(cell, attacker);
+        // the attacker had no four before, so every one now goes through cell
+        const int fours = _board.winningCellsThrough(cell, attacker, cells);
+        bool win = fours >= 2;
+        if (fours == 1) {
+            const int block = cells[0];
+            int next;
+            win = !_board.place(block, defender) && vcf(attacker, depth - 1, ply + 1, &next);
+            _board.remove(block);
+        }
+        _board.remove(cell);
+
+        if (win) {
+            store(key, kWin, depth, cell);
+            *move = cell;
+            return true;
+        }
+        if (_aborted) {
+            return false;
+        }
+    }
+    store(key, kNoWin, depth, -1);
+    return false;
+}
+
+//
+// threes and fours for attacker, a move counts when the attacker would have a VCF
+// after it and no defender reply takes that away
+//
+bool ThreatSearch::vct(int attacker, int depth, int ply, int *move)
+{
+    _nodeCount++;
+    if (outOfTime()) {
+        return false;
+    }
+    const int defender = 1 - attacker;
+    if (_board.hasThreat(attacker)) {
+        _board.winningCells(attacker, _winningCells.data());
+        *move = _winningCells[0];
+        return true;
+    }
+    if (_board.hasThreat(defender)) {
+        return false;
+    }
+    if (vcf(attacker, kMaxVCFDepth, ply, move)) {
+        return true;
+    }
+    if (depth == 0 || _aborted) {
+        return false;
+    }
+
+    const uint64_t key = _board.hash() ^ TABLE_SALT[1][attacker];
+    if (Entry *entry = probe(key)) {
+        if (entry->result == kWin) {
+            *move = entry->move;
+            return true;
+        }
+        if (entry->depth >= depth) {
+            return false;
+        }
+    }
+
+    int *moves;
+    const int count = gatherMoves(attacker, _board.winLength() - 2, ply, moves);
+    for (int i = 0; i < count; i++) {
+        const int cell = moves[i];
+        _board.place(cell, attacker);
+        // a threat is a move that would leave a VCF if the defender passed
+        int next;
+        bool win = vcf(attacker, kMaxVCFDepth, ply + 1, &next);
+        if (win) {
+            int *replies;
+            const int replyCount = gatherReplies(ply, replies);
+            for (int r = 0; r < replyCount && win; r++) {
+                const int reply = replies[r];
+                win = !_board.place(reply, defender) && vct(attacker, depth - 1, ply + 1, &next);
+                _board.remove(reply);
+            }
+        }
+        _board.remove(cell);
+
+        if (win && !_aborted) {
+            store(key, kWin, depth, cell);
+            *move = cell;
+            return true;
+        }
+        if (_aborted) {
+            return false;
+        }
+    }
+    store(key, kNoWin, depth, -1);
+    return false;
+}
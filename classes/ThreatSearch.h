@@ -0,0 +1,95 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include "KInARowBoard.h"
+
+//
+// threat space search: looks only at forcing moves to find a win the opponent
+// can't stop, long before a full width search would get that deep.
+//
+// a four is a move that leaves a line one piece short with nothing of the
+// opponent's in it. the opponent has exactly one reply, so a chain of fours
+// (VCF, victory by continuous fours) is searched with one defender move per ply
+// and ends in a win once a move makes two fours at once.
+//
+// VCT (victory by continuous threats) also allows threes: any move after which
+// the attacker would have a VCF if the opponent passed. the defender then gets
+// to try every empty cell, and the threat only counts if each reply still loses,
+// so a win reported is always a real one. moves that make a run too far from
+// every piece aren't tried, so a win can be missed but never made up.
+//
+// results are kept in a table keyed by the board's zobrist key, from one move
+// to the next until the board changes shape. wins hold forever, failures only
+// for searches no deeper than the one that stored them, and a search cut short
+// by the clock stores nothing it didn't finish
+//
+class ThreatSearch
+{
+public:
+    // entries in the result table, 16 bytes each
+    static constexpr int kTableSize = 1 << 18;
+    // attacker moves in one chain of fours
+    static constexpr int kMaxVCFDepth = 24;
+    // threat moves in a VCT, each one runs a VCF per defender reply
+    static constexpr int kMaxVCTDepth = 3;
+
+    ThreatSearch();
+
+    // first move of a forced win for player, a VCF if there is one and then a VCT
+    // found within the time budget, -1 if there is neither
+    int         findForcedWin(const KInARowBoard &board, int player, int timeBudgetMs);
+    // nodes visited by the last findForcedWin
+    int         nodeCount() const { return _nodeCount; }
+    // threat moves the win found needed on top of its fours, 0 for a plain VCF
+    int         threatDepth() const { return _threatDepth; }
+    // wall clock time the last findForcedWin took
+    int         elapsedMs() const { return _elapsedMs; }
+    // when *stop turns true the search gives up without a result
+    void        setStopFlag(const std::atomic<bool> *stop) { _stop = stop; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    enum Result : uint8_t
+    {
+        kUnknown,
+        kWin,
+        kNoWin
+    };
+
+    struct Entry
+    {
+        uint64_t    key;
+        int16_t     move;
+        int8_t      depth;
+        Result      result;
+    };
+
+    bool        vcf(int attacker, int depth, int ply, int *move);
+    bool        vct(int attacker, int depth, int ply, int *move);
+    // moves that give attacker a run of at least length, into ply's attacker slot
+    int         gatherMoves(int attacker, int length, int ply, int *&moves);
+    // every empty cell, candidates first, into ply's defender slot
+    int         gatherReplies(int ply, int *&moves);
+    Entry       *probe(uint64_t key);
+    void        store(uint64_t key, Result result, int depth, int move);
+    bool        outOfTime();
+
+    KInARowBoard        _board;
+    std::vector<Entry>  _table;
+    // the board shape the table's entries are for
+    int                 _tableWidth;
+    int                 _tableHeight;
+    int                 _tableWinLength;
+    // two move lists per ply, the attacker's and the defender's
+    std::vector<int>    _moveStack;
+    std::vector<int>    _winningCells;
+    int                 _nodeCount;
+    int                 _threatDepth;
+    int                 _elapsedMs;
+    bool                _aborted;
+    Clock::time_point   _deadline;
+    const std::atomic<bool> *_stop;
+};
@@ -1,4 +1,9 @@
 #include "TicTacToe.h"
+#include "TicTacToeSolved.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
 
 // -----------------------------------------------------------------------------
 // TicTacToe.cpp
@@ -8,10 +13,11 @@
 // Bit / BitHolder grid system.
 //
 // Rules recap:
-//  - Two players place X / O on a 3x3 grid.
+//  - Two players place X / O on a 3x3 grid (or any rowX x rowY grid).
 //  - Players take turns; you can only place into an empty square.
 //  - First player to get three-in-a-row (row, column, or diagonal) wins.
-//  - If all 9 squares are filled and nobody wins, it’s a draw.
+//    on bigger boards the line length is configurable, e.g. 5 on 15x15.
+//  - If all squares are filled and nobody wins, it’s a draw.
 //
 // Notes about the provided engine types you'll use here:
 //  - Bit              : a visual piece (sprite) that belongs to a Player
@@ -27,14 +33,67 @@
 const int AI_PLAYER   = 1;      // index of the AI player (O)
 const int HUMAN_PLAYER= 0;      // index of the human player (X)
 
+const int INFINITE_SCORE = 1000;
+
+// largest width or height the board is drawn at, in pixels
+const float BOARD_PIXELS = 800.0f;
+
+// static move ordering: center, then corners, then edges
+const int SQUARE_ORDER_BONUS[TicTacToeBoard::kSquares] = {
+    2, 1, 2,
+    1, 3, 1,
+    2, 1, 2
+};
+
+//
+// transposition table shared by every TicTacToe game so it stays warm across
+// turns and across games. it is indexed by the canonical position seen from the
+// side to move, and each entry packs score, bound and best move into one word
+// so concurrent searches can share it without locking
+//
+enum TableBound
+{
+    kBoundNone = 0,
+    kBoundExact,
+    kBoundLower,
+    kBoundUpper
+};
+
+static std::atomic<uint32_t> s_transpositionTable[TicTacToeBoard::kPositions];
+
+// scores are stored relative to the node so they stay valid at any depth
+static inline uint32_t packTableEntry(int score, int depth, int bound, int move)
+{
+    int nodeScore = (score > 0) ? score + depth : (score < 0) ? score - depth : 0;
+    return (uint32_t)(uint8_t)(int8_t)nodeScore | (uint32_t)(bound << 8) | (uint32_t)(move << 10);
+}
+
+static inline int tableEntryScore(uint32_t entry, int depth)
+{
+    int nodeScore = (int8_t)(entry & 0xff);
+    return (nodeScore > 0) ? nodeScore - depth : (nodeScore < 0) ? nodeScore + depth : 0;
+}
+
+static inline int tableEntryBound(uint32_t entry) { return (entry >> 8) & 0x3; }
+static inline int tableEntryMove(uint32_t entry) { return (entry >> 10) & 0xf; }
+
 TicTacToe::TicTacToe()
 {
     _aiMoved = false;
     _aiEnabled = true;  // AI is enabled by default
+    _aiMode = kAIModeNegamax;
+    _aiThreaded = true;
+    _aiCancel = false;
+    _aiNodeCount = 0;
+    _winLength = 3;
+    _cellSize = 100.0f;
+    _gameOptions.rowX = 3;
+    _gameOptions.rowY = 3;
 }
 
 TicTacToe::~TicTacToe()
 {
+    cancelAI();
 }
 
 // -----------------------------------------------------------------------------
@@ -50,6 +109,16 @@ Bit* TicTacToe::PieceForPlayer(const int playerNumber)
     return bit;
 }
 
+//
+// pick the grid for the next game, takes effect in setUpBoard
+//
+void TicTacToe::setBoardSize(int columns, int rows, int winLength)
+{
+    _gameOptions.rowX = std::clamp(columns, 1, KInARowBoard::kMaxDimension);
+    _gameOptions.rowY = std::clamp(rows, 1, KInARowBoard::kMaxDimension);
+    _winLength = std::clamp(winLength, 1, std::max(_gameOptions.rowX, _gameOptions.rowY));
+}
+
 //
 // setup the game board, this is called once at the start of the game
 //
@@ -61,21 +130,68 @@ void TicTacToe::setUpBoard()
     // Reset AI flag
     _aiMoved = false;
     
-    // grid options
-    _gameOptions.rowX = 3;
-    _gameOptions.rowY = 3;
+    // grid options come from setBoardSize, squares shrink so big boards still fit
+    const int columns = _gameOptions.rowX;
+    const int rows = _gameOptions.rowY;
+    _cellSize = std::min(100.0f, BOARD_PIXELS / (float)std::max(columns, rows));
+
+    // the bits point back at their holders, so empty the grid before it moves
+    if ((int)_grid.size() != columns * rows) {
+        stopGame();
+        _grid.clear();
+        _grid.resize(columns * rows);
+    }
     
-    // Initialize each square
-    for (int y = 0; y < 3; y++) {
-        for (int x = 0; x < 3; x++) {
-            ImVec2 position((float)(x * 100 + 50), (float)(y * 100 + 50));
-            _grid[y][x].initHolder(position, "square.png", x, y);
+    // Initialize each square, the game tag is its index in the grid
+    const ImVec2 origin(50.0f, 50.0f);
+    for (int y = 0; y < rows; y++) {
+        for (int x = 0; x < columns; x++) {
+            ImVec2 position((float)x * _cellSize + origin.x, (float)y * _cellSize + origin.y);
+            Square &square = _grid[y * columns + x];
+            square.initHolder(position, "square.png", x, y);
+            square.setSize(_cellSize, _cellSize);
+            square.setGameTag(y * columns + x);
+            trackHolder(square, y * columns + x);
         }
     }
+    setGridGeometry(origin, _cellSize);
+    _board.reset(columns, rows, _winLength);
     
     startGame();
 }
 
+//
+// make a piece for playerNumber and drop it into the square at index
+//
+Bit* TicTacToe::placePiece(int index, int playerNumber)
+{
+    Square &square = _grid[index];
+    Bit *bit = PieceForPlayer(playerNumber);
+    bit->setPosition(square.getPosition());
+    bit->setSize(_cellSize, _cellSize);
+    square.setBit(bit);
+
+    if (!_board.empty(index)) {
+        _board.remove(index);
+    }
+    _board.place(index, playerNumber);
+    recordChange(index, playerNumber + 1);
+    return bit;
+}
+
+//
+// take the piece off the square at index
+//
+void TicTacToe::clearSquare(int index)
+{
+    const bool occupied = !_board.empty(index);
+    _grid[index].destroyBit();
+    _board.remove(index);
+    if (occupied) {
+        recordChange(index, 0);
+    }
+}
+
 bool TicTacToe::actionForEmptyHolder(BitHolder *holder)
 {
     if (!holder) return false;
@@ -83,17 +199,17 @@ bool TicTacToe::actionForEmptyHolder(BitHolder *holder)
     if (!holder->empty()) return false;
     
     // Check if game is over
-    if (checkForWinner() != nullptr) return false;
-    if (checkForDraw()) return false;
+    if (_board.winner() >= 0 || _board.full()) return false;
 
     //put the player's piece on the holder
     Player *currentPlayer = getCurrentPlayer();
     if (!currentPlayer) return false;
     
     int playerNum = currentPlayer->playerNumber();
-    Bit *newBit = PieceForPlayer(playerNum);
-    newBit->setPosition(holder->getPosition());
-    holder->setBit(newBit);
+
+    // the AI's squares are placed by the AI, even while it is still thinking
+    if (_aiEnabled && (playerNum == AI_PLAYER || _gameOptions.AIvsAI)) return false;
+    placePiece(holder->gameTag(), playerNum);
     
     // Reset AI flag when human makes a move
     if (playerNum == HUMAN_PLAYER) {
@@ -120,121 +236,87 @@ bool TicTacToe::canBitMoveFromTo(Bit* bit, BitHolder*src, BitHolder*dst)
 //
 void TicTacToe::stopGame()
 {
+    // a search still running would commit a move to the next game
+    cancelAI();
+
     // clear out the board
-    for (int y = 0; y < 3; y++) {
-        for (int x = 0; x < 3; x++) {
-            _grid[y][x].destroyBit();
-        }
+    for (int i = 0; i < (int)_grid.size(); i++) {
+        clearSquare(i);
     }
 }
 
-//
-// helper function for the winner check
-//
-Player* TicTacToe::ownerAt(int index ) const
-{
-    // index is 0..8, convert to x,y using:
-    int y = index / 3;
-    int x = index % 3;
-    
-    Bit *bit = _grid[y][x].bit();
-    
-    if (!bit) return nullptr;
-
-    return bit->getOwner();
-}
-
 Player* TicTacToe::checkForWinner()
 {
-    // All winning triples
-    int winningCombinations[8][3] = {
-        {0, 1, 2},  
-        {3, 4, 5},  
-        {6, 7, 8}, 
-        {0, 3, 6}, 
-        {1, 4, 7}, 
-        {2, 5, 8},  
-        {0, 4, 8},  
-        {2, 4, 6}  
-    };
-    
-    // check each winning combination
-    for (int i = 0; i < 8; i++) {
-        Player *owner0 = ownerAt(winningCombinations[i][0]);
-        Player *owner1 = ownerAt(winningCombinations[i][1]);
-        Player *owner2 = ownerAt(winningCombinations[i][2]);
-        
-        // if all three positions have the same owner and it's not nullptr
-        if (owner0 != nullptr && owner0 == owner1 && owner1 == owner2) {
-            return owner0;
-        }
-    }
-    
-    return nullptr;
+    // _board keeps a piece count for every line, so this is a lookup
+    int winner = _board.winner();
+    if (winner < 0) return nullptr;
+
+    return getPlayerAt(winner);
 }
 
 bool TicTacToe::checkForDraw()
 {
     // Check if all squares are filled
-    for (int y = 0; y < 3; y++) {
-        for (int x = 0; x < 3; x++) {
-            if (_grid[y][x].empty()) {
-                return false;
-            }
-        }
-    }
-    return true;
+    return _board.full();
 }
 
 // state strings
 std::string TicTacToe::initialStateString()
 {
-    return "000000000";
+    return std::string(_gameOptions.rowX * _gameOptions.rowY, '0');
 }
 
 //
 // this still needs to be tied into imguis init and shutdown
 std::string TicTacToe::stateString() const
 {
-    std::string result = "";
-    
-    // Iterate through the board left-to-right, top-to-bottom
-    for (int y = 0; y < 3; y++) {
-        for (int x = 0; x < 3; x++) {
-            Bit *bit = _grid[y][x].bit();
-            if (bit == nullptr) {
-                result += '0';
-            } else {
-                // player numbers are 0-based so add 1
-                int playerNum = bit->getOwner()->playerNumber() + 1;
-                result += std::to_string(playerNum);
-            }
-        }
-    }
-    
+    std::string result;
+    writeStateString(result);
     return result;
 }
 
+//
+// one character a square left-to-right, top-to-bottom: 0 empty, else player number + 1
+// the text is only an adapter over the packed state, no allocation once s has the capacity
+//
+void TicTacToe::writeStateString(std::string &s) const
+{
+    PackedBoardState state;
+    getPackedState(state);
+    state.toString(s);
+}
+
 void TicTacToe::setStateString(const std::string &s)
 {
-    int index = 0;
-    
-    for (int y = 0; y < 3; y++) {
-        for (int x = 0; x < 3; x++) {
-            if (index >= s.length()) break;
-            
-            int playerNumber = s[index] - '0';
-            
-            if (playerNumber == 0) {
-                _grid[y][x].setBit(nullptr);
-            } else if (playerNumber == 1 || playerNumber == 2) {
-                int playerIdx = playerNumber - 1;
-                Bit *bit = PieceForPlayer(playerIdx);
-                bit->setPosition(_grid[y][x].getPosition());
-                _grid[y][x].setBit(bit);
-            }
-            
-            index++;
+    // squares past the end of s keep what they have, a string with any
+    // other character than 0, 1 or 2 in it changes nothing
+    PackedBoardState state;
+    if (state.fromString(s)) {
+        setPackedState(state);
+    }
+}
+
+void TicTacToe::getPackedState(PackedBoardState &state) const
+{
+    state.clear(_board.cellCount());
+    for (int index = 0; index < _board.cellCount(); index++) {
+        state.set(index, _board.ownerAt(index) + 1);
+    }
+}
+
+void TicTacToe::setPackedState(const PackedBoardState &state)
+{
+    const int count = std::min(state.cellCount, _board.cellCount());
+    for (int index = 0; index < count; index++) {
+        // 3 isn't a player, leave those squares alone
+        const int playerNumber = state.get(index) - 1;
+        if (playerNumber == _board.ownerAt(index) || playerNumber > 1) {
+            continue;
+        }
+        if (playerNumber < 0) {
+            clearSquare(index);
+        } else {
+            placePiece(index, playerNumber);
         }
     }
 }
@@ -245,156 +327,304 @@ void TicTacToe::setStateString(const std::string &s)
 //
 void TicTacToe::updateAI() 
 {
+    PROFILE_SCOPE("updateAI");
+    // a search is running on the worker thread, play its move once it is done
+    if (_aiSearch.valid()) {
+        if (_aiSearch.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            commitAIMove(_aiSearch.get());
+        }
+        return;
+    }
+
     // Check if AI is enabled
     if (!_aiEnabled) return;
     
-    // AI plays as Player 1 (O)
-    if (getCurrentPlayer()->playerNumber() == AI_PLAYER && !_aiMoved) {
+    // AI plays as Player 1 (O), or both sides in AI vs AI
+    const int playerNum = getCurrentPlayer()->playerNumber();
+    if ((playerNum == AI_PLAYER || _gameOptions.AIvsAI) && !_aiMoved) {
         // Check if game over
-        if (checkForWinner() || checkForDraw()) {
+        if (_board.winner() >= 0 || _board.full()) {
             return;
         }
         
         _aiMoved = true;
 
-        makeAIMove(AI_PLAYER);
+        if (_aiThreaded) {
+            // the worker gets its own copy of the board, the grid is only touched here
+            _aiCancel = false;
+            _aiSearch = std::async(std::launch::async, &TicTacToe::searchAIMove, this,
+                                   _board, playerNum, _gameOptions.AITimeBudget, _gameOptions.AIThreads, _aiMode);
+        } else {
+            makeAIMove(playerNum);
+        }
+    }
+}
+
+bool TicTacToe::aiPending()
+{
+    if (_aiSearch.valid()) {
+        return true;
+    }
+    if (!_aiEnabled || _aiMoved || !getCurrentPlayer()) {
+        return false;
+    }
+    const int playerNum = getCurrentPlayer()->playerNumber();
+    return (playerNum == AI_PLAYER || _gameOptions.AIvsAI) && _board.winner() < 0 && !_board.full();
+}
+
+void TicTacToe::cancelAI()
+{
+    if (_aiSearch.valid()) {
+        _aiCancel = true;
+        _aiSearch.wait();
+        _aiSearch = std::future<AIMoveResult>();
+        _aiCancel = false;
     }
 }
 
 //
-// Get the current board state as an integer array
-// 0 = empty, 1 = AI player, 2 = human player
+// Get a 3x3 board state as a packed bitboard
+// pieces[0] = human player, pieces[1] = AI player
 //
-void TicTacToe::getBoardState(int board[9])
+TicTacToeBoard TicTacToe::getBoardState(const KInARowBoard &position)
 {
-    for (int i = 0; i < 9; i++) {
-        int y = i / 3;
-        int x = i % 3;
-        Bit* bit = _grid[y][x].bit();
-        if (!bit) {
-            board[i] = 0;
-        } else {
-            board[i] = bit->getOwner()->playerNumber() + 1;
+    TicTacToeBoard board;
+    for (int i = 0; i < TicTacToeBoard::kSquares; i++) {
+        int owner = position.ownerAt(i);
+        if (owner >= 0) {
+            board.place(i, owner);
         }
     }
+    return board;
 }
 
 
-//positive if AI is winning, negative if human is winning, 0 for neutral/draw
-int TicTacToe::evaluateBoard(int board[9])
+//
+// positive if player has won, negative if the opponent has, 0 for neutral/draw
+//
+int TicTacToe::evaluateBoard(const TicTacToeBoard &board, int player)
 {
-    // Check all winning combinations
-    int winningCombinations[8][3] = {
-        {0, 1, 2}, {3, 4, 5}, {6, 7, 8},  // rows
-        {0, 3, 6}, {1, 4, 7}, {2, 5, 8},  // columns
-        {0, 4, 8}, {2, 4, 6}              // diagonals
-    };
-    
-    for (int i = 0; i < 8; i++) {
-        int a = board[winningCombinations[i][0]];
-        int b = board[winningCombinations[i][1]];
-        int c = board[winningCombinations[i][2]];
-        
-        if (a != 0 && a == b && b == c) {
-            // Someone won
-            return (a == 2) ? 10 : -10;
+    // the rule lives on the board so the compile time solved table shares it
+    return board.evaluate(player);
+}
+
+//
+// fill moves[] with the empty squares, best candidates first
+// table move, killer move for this depth, history score, then center/corners/edges
+//
+int TicTacToe::orderMoves(uint16_t empties, int depth, int player, int tableMove, int moves[TicTacToeBoard::kSquares])
+{
+    int keys[TicTacToeBoard::kSquares];
+    int count = 0;
+
+    for (; empties; empties &= empties - 1) {
+        int square = std::countr_zero(empties);
+        int key = (_historyScores[player][square] << 2) + SQUARE_ORDER_BONUS[square];
+        if (square == tableMove) {
+            key = INT32_MAX;
+        } else if (square == _killerMoves[depth]) {
+            key = INT32_MAX - 1;
+        }
+
+        // insertion sort, there are never more than 9 moves
+        int i = count++;
+        for (; i > 0 && keys[i - 1] < key; i--) {
+            keys[i] = keys[i - 1];
+            moves[i] = moves[i - 1];
         }
+        keys[i] = key;
+        moves[i] = square;
     }
-    
-    return 0;  // No winner yet
+
+    return count;
 }
 
-// Negamax algorithm using integer board representation
-int TicTacToe::negamax(int board[9], int depth, int color)
+//
+// Negamax with alpha-beta pruning and a transposition table on the bitboard
+// returns the score for player (the side to move); wins found closer to the
+// root score higher so the AI takes the fastest win and delays a loss
+// at the root bestMove receives the square to play
+//
+int TicTacToe::negamax(TicTacToeBoard &board, int depth, int alpha, int beta, int player, int *bestMove)
 {
-    // Check if game is over
-    int boardScore = evaluateBoard(board);
+    _aiNodeCount++;
+
+    // Check if game is over, only the side that just moved can have won
+    int boardScore = evaluateBoard(board, player);
     if (boardScore != 0) {
-        return color * boardScore;
+        return (boardScore > 0) ? boardScore - depth : boardScore + depth;
     }
-    
+
     // Check for draw
-    bool hasEmpty = false;
-    for (int i = 0; i < 9; i++) {
-        if (board[i] == 0) {
-            hasEmpty = true;
-            break;
+    uint16_t empties = board.empties();
+    if (!empties) return 0;
+
+    // transposition table probe
+    int alphaOrig = alpha;
+    int symmetry = 0;
+    int index = canonicalIndex(board, player, symmetry);
+    uint32_t entry = s_transpositionTable[index].load(std::memory_order_relaxed);
+    int tableMove = -1;
+    if (tableEntryBound(entry) != kBoundNone) {
+        int tableScore = tableEntryScore(entry, depth);
+        int bound = tableEntryBound(entry);
+        tableMove = kTicTacToeSymmetry.inverse[symmetry][tableEntryMove(entry)];
+        if (bound == kBoundExact ||
+            (bound == kBoundLower && tableScore >= beta) ||
+            (bound == kBoundUpper && tableScore <= alpha)) {
+            if (bestMove) {
+                *bestMove = tableMove;
+            }
+            return tableScore;
         }
     }
-    if (!hasEmpty) return 0;
-    
-    // Safety: max depth
-    if (depth > 9) return 0;
-    
-    int maxScore = -1000;
-    int currentPlayer = (color == 1) ? 2 : 1;  // 2 = AI, 1 = Human
-    
-    // Try all possible moves
-    for (int i = 0; i < 9; i++) {
-        if (board[i] == 0) {
-            // Make move
-            board[i] = currentPlayer;
-            
-            // Recursive call
-            int score = -negamax(board, depth + 1, -color);
-            
-            // Undo move
-            board[i] = 0;
-            
-            if (score > maxScore) {
-                maxScore = score;
-            }
+
+    int moves[TicTacToeBoard::kSquares];
+    int count = orderMoves(empties, depth, player, tableMove, moves);
+
+    int maxScore = -INFINITE_SCORE;
+    int maxMove = moves[0];
+    for (int i = 0; i < count; i++) {
+        int square = moves[i];
+
+        // Make move
+        board.place(square, player);
+
+        // Recursive call
+        int score = -negamax(board, depth + 1, -beta, -alpha, 1 - player);
+
+        // Undo move
+        board.clear(square, player);
+
+        if (score > maxScore) {
+            maxScore = score;
+            maxMove = square;
+        }
+        if (score > alpha) {
+            alpha = score;
+        }
+        if (alpha >= beta) {
+            // remember the refutation for sibling nodes and later searches
+            _killerMoves[depth] = square;
+            _historyScores[player][square] += (TicTacToeBoard::kSquares - depth) * (TicTacToeBoard::kSquares - depth);
+            break;
         }
     }
-    
+
+    int bound = (maxScore <= alphaOrig) ? kBoundUpper : (maxScore >= beta) ? kBoundLower : kBoundExact;
+    s_transpositionTable[index].store(packTableEntry(maxScore, depth, bound, kTicTacToeSymmetry.squares[symmetry][maxMove]),
+                                      std::memory_order_relaxed);
+
+    if (bestMove) {
+        *bestMove = maxMove;
+    }
     return maxScore;
 }
 
 // Make the best move for the AI using negamax
 bool TicTacToe::makeAIMove(int playerNum)
 {
-    int board[9];
-    getBoardState(board);
-    
-    int bestScore = -1000;
-    int bestMove = -1;
-    
-    for (int i = 0; i < 9; i++) {
-        if (board[i] == 0) {
-            // Try this move
-            board[i] = 2;  // AI is player 1, which is represented as 2 in the board array
-            
-            // Evaluate
-            int score = -negamax(board, 1, -1);
-            
-            // Undo
-            board[i] = 0;
-            
-            // Track best
-            if (score > bestScore) {
-                bestScore = score;
-                bestMove = i;
-            }
+    return commitAIMove(searchAIMove(_board, playerNum, _gameOptions.AITimeBudget, _gameOptions.AIThreads, _aiMode));
+}
+
+//
+// work out the AI's move without touching the grid
+// std::async hands the worker thread its own copy of the board, so this only
+// touches the search state and can run there
+//
+AIMoveResult TicTacToe::searchAIMove(const KInARowBoard &board, int playerNum, int timeBudget, int threads, AIMode mode)
+{
+    PROFILE_SCOPE("AI search");
+    AIMoveResult result = { -1, playerNum, 0, 0, 0 };
+    if (!isClassicBoard(board)) {
+        // a forced win turns up in a few milliseconds when there is one, and is played at once
+        // otherwise whatever time it took comes out of the main search's budget
+        _threatSearch.setStopFlag(&_aiCancel);
+        const int move = _threatSearch.findForcedWin(board, playerNum, timeBudget / 4);
+        if (move >= 0) {
+            result.move = move;
+            result.nodes = _threatSearch.nodeCount();
+            result.depth = _threatSearch.threatDepth();
+            result.milliseconds = _threatSearch.elapsedMs();
+            return result;
         }
+        timeBudget = std::max(timeBudget - _threatSearch.elapsedMs(), 1);
     }
-    
+    if (mode == kAIModeMCTS) {
+        // nodes is the number of games played out, depth how far the tree grew
+        _treeSearch.setStopFlag(&_aiCancel);
+        _treeSearch.setThreadCount(threads);
+        result.move = _treeSearch.findBestMove(board, playerNum, timeBudget);
+        result.nodes = _treeSearch.playoutCount();
+        result.depth = _treeSearch.depthReached();
+        result.milliseconds = _treeSearch.elapsedMs();
+    } else if (isClassicBoard(board)) {
+        TicTacToeBoard classic = getBoardState(board);
+        result.move = findClassicMove(classic, playerNum, mode);
+        // the 3x3 search always runs to the end of the game
+        result.nodes = _aiNodeCount;
+        result.depth = (_aiNodeCount > 0) ? std::popcount(classic.empties()) : 0;
+    } else {
+        // bigger boards go through the iterative deepening m,n,k search
+        // the root moves are split across threads, 3x3 is too small to bother
+        _boardSearch.setStopFlag(&_aiCancel);
+        _boardSearch.setThreadCount(threads);
+        result.move = _boardSearch.findBestMove(board, playerNum, timeBudget);
+        result.nodes = _boardSearch.nodeCount();
+        result.depth = _boardSearch.depthReached();
+        result.milliseconds = _boardSearch.elapsedMs();
+    }
+    return result;
+}
+
+bool TicTacToe::commitAIMove(const AIMoveResult &result)
+{
+    _gameOptions.AIDepthSearches = result.nodes;
+    _gameOptions.AIMAXDepth = result.depth;
+    _gameOptions.AISearchTime = result.milliseconds;
+
     // Make the best move on the actual board
-    if (bestMove != -1) {
-        int y = bestMove / 3;
-        int x = bestMove % 3;
-        
-        if (_grid[y][x].empty()) {
-            Bit* bit = PieceForPlayer(playerNum);
-            if (bit) {
-                bit->setPosition(_grid[y][x].getPosition());
-                _grid[y][x].setBit(bit);
-                endTurn();
-                return true;
-            }
-        }
+    if (result.move < 0 || result.move >= (int)_grid.size() || !_grid[result.move].empty()) {
+        return false;
     }
-    
-    return false;
+    if (_board.winner() >= 0 || getCurrentPlayer()->playerNumber() != result.player) {
+        return false;
+    }
+    placePiece(result.move, result.player);
+    // in AI vs AI the other side searches next
+    _aiMoved = false;
+    endTurn();
+    return true;
 }
 
+//
+// best square on the 3x3 board, either searched or looked up
+//
+int TicTacToe::findClassicMove(const TicTacToeBoard &position, int playerNum, AIMode mode)
+{
+    TicTacToeBoard board = position;
+
+    for (int &killer : _killerMoves) {
+        killer = -1;
+    }
+    for (auto &scores : _historyScores) {
+        for (int &score : scores) {
+            score = 0;
+        }
+    }
+    _aiNodeCount = 0;
 
+    int bestMove = -1;
+    if (mode == kAIModeSolvedTable) {
+        // no search at all, the answer was worked out by the compiler
+        bestMove = kTicTacToeSolved.lookup(board, playerNum).move;
+    } else {
+        int score = negamax(board, 0, -INFINITE_SCORE, INFINITE_SCORE, playerNum, &bestMove);
+        // the solved table is the reference every search has to agree with
+        assert(score == kTicTacToeSolved.lookup(board, playerNum).score);
+        (void)score;
+    }
+
+    
+    return bestMove;
+}
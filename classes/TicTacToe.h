@@ -1,11 +1,42 @@
 #pragma once
+#include <atomic>
+#include <future>
 #include "Game.h"
 #include "Square.h"
+#include "TicTacToeBoard.h"
+#include "KInARowBoard.h"
+#include "KInARowSearch.h"
+#include "KInARowMCTS.h"
+#include "ThreatSearch.h"
+#include "PackedBoardState.h"
 
 //
-// the classic game of tic tac toe
+// the classic game of tic tac toe, played on any rowX x rowY grid with any
+// winning line length (3x3 with 3 in a row by default, 15x15 with 5 for gomoku)
 //
 
+//
+// how the AI picks its move
+//
+enum AIMode
+{
+    kAIModeNegamax,         // alpha-beta search with the shared transposition table
+    kAIModeSolvedTable,     // constant time lookup in the compile time solved table
+    kAIModeMCTS             // monte carlo tree search on any board, for grids negamax can't see through
+};
+
+//
+// what an AI search decided, handed from the worker thread back to the game
+//
+struct AIMoveResult
+{
+    int         move;       // cell to play, -1 if the search was cancelled
+    int         player;
+    int         nodes;
+    int         depth;
+    int         milliseconds;   // time the search took, 0 for the 3x3 board
+};
+
 //
 // the main game class
 //
@@ -23,6 +54,11 @@ public:
     std::string initialStateString() override;
     std::string stateString() const override;
     void        setStateString(const std::string &s) override;
+    void        writeStateString(std::string &s) const override;
+    // the board 2 bits a cell, the string functions above are adapters over these
+    void        getPackedState(PackedBoardState &state) const override;
+    // only the cells that differ from the current board are touched
+    void        setPackedState(const PackedBoardState &state);
     bool        actionForEmptyHolder(BitHolder *holder) override;
     bool        canBitMoveFrom(Bit*bit, BitHolder *src) override;
     bool        canBitMoveFromTo(Bit* bit, BitHolder*src, BitHolder*dst) override;
@@ -30,21 +66,65 @@ public:
 
 	void        updateAI() override;
     bool        gameHasAI() override { return true; }
-    BitHolder &getHolderAt(const int x, const int y) override { return _grid[y][x]; }
+    BitHolder &getHolderAt(const int x, const int y) override { return _grid[y * _gameOptions.rowX + x]; }
+
+    // board size and line length used by the next setUpBoard
+    void        setBoardSize(int columns, int rows, int winLength);
+    int         getWinLength() const { return _winLength; }
     
+    // is a search running on the worker thread right now
+    bool        aiThinking() const { return _aiSearch.valid(); }
+    // the AI is searching or will start its move on the next updateAI
+    bool        aiPending();
+
     bool        _aiEnabled;
+    AIMode      _aiMode;
+    // search on a worker thread and commit the move on a later updateAI
+    // turn off to have updateAI play the move before it returns
+    bool        _aiThreaded;
     
 private:
     Bit *       PieceForPlayer(const int playerNumber);
-    Player*     ownerAt(int index ) const;
+    // every change to the grid goes through these two so _board stays in sync
+    Bit *       placePiece(int index, int playerNumber);
+    void        clearSquare(int index);
+    // true for the 3x3, three in a row game the bitboard AI and solved table cover
+    static bool isClassicBoard(const KInARowBoard &board) { return board.width() == 3 && board.height() == 3 && board.winLength() == 3; }
     
-    int         negamax(int board[9], int depth, int color);
-    int         evaluateBoard(int board[9]);
-    void        getBoardState(int board[9]);
+    int         negamax(TicTacToeBoard &board, int depth, int alpha, int beta, int player, int *bestMove = nullptr);
+    int         evaluateBoard(const TicTacToeBoard &board, int player);
+    int         orderMoves(uint16_t empties, int depth, int player, int tableMove, int moves[TicTacToeBoard::kSquares]);
+    static TicTacToeBoard getBoardState(const KInARowBoard &position);
     bool        makeAIMove(int playerNum);
+    // the search half of makeAIMove, safe to run off the main thread
+    AIMoveResult searchAIMove(const KInARowBoard &board, int playerNum, int timeBudget, int threads, AIMode mode);
+    // the main thread half, puts the piece on the grid and ends the turn
+    bool        commitAIMove(const AIMoveResult &result);
+    // stop a running search and wait for the worker to finish
+    void        cancelAI();
+    int         findClassicMove(const TicTacToeBoard &board, int playerNum, AIMode mode);
     
     bool        _aiMoved;
+    // nodes visited by the current 3x3 search
+    int         _aiNodeCount;
+
+    // move ordering state, cleared at the start of every search
+    int         _killerMoves[TicTacToeBoard::kSquares + 1];
+    int         _historyScores[2][TicTacToeBoard::kSquares];
+
+    int         _winLength;
+    float       _cellSize;
+    KInARowSearch _boardSearch;
+    // kept between moves so the tree carries over to the next search
+    KInARowMCTS _treeSearch;
+    // forced wins out of fours and threes, tried before either search above
+    ThreatSearch _threatSearch;
+
+    std::future<AIMoveResult> _aiSearch;
+    std::atomic<bool> _aiCancel;
 
-    Square      _grid[3][3];
+    std::vector<Square> _grid;
+    // mirror of _grid with per line piece counts, answers winner and draw in O(1)
+    KInARowBoard _board;
 };
 
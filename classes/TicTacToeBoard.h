@@ -0,0 +1,151 @@
+#pragma once
+#include <bit>
+#include <cstdint>
+
+//
+// packed 3x3 tic tac toe position
+// one 9 bit mask per player, bit i is square i (left-to-right, top-to-bottom)
+// this is what the AI searches on and what checkForWinner / checkForDraw test,
+// so a win check is a few AND/compare ops instead of walking the grid
+//
+struct TicTacToeBoard
+{
+    static constexpr int      kSquares = 9;
+    static constexpr int      kPositions = 19683;     // 3^9
+    static constexpr uint16_t kFullBoard = 0x1ff;
+    static constexpr int      kWinScore = 10;         // score for a win on the very next move
+
+    // all winning triples as masks
+    static constexpr uint16_t kWinningLines[8] = {
+        0x007, 0x038, 0x1c0,    // rows
+        0x049, 0x092, 0x124,    // columns
+        0x111, 0x054            // diagonals
+    };
+
+    // indexed by player number (0 or 1)
+    uint16_t    pieces[2];
+
+    constexpr TicTacToeBoard() : pieces{0, 0} {}
+
+    constexpr uint16_t  occupied() const { return pieces[0] | pieces[1]; }
+    constexpr uint16_t  empties() const { return (uint16_t)(~occupied() & kFullBoard); }
+    constexpr bool      full() const { return occupied() == kFullBoard; }
+    constexpr int       pieceCount() const { return std::popcount(occupied()); }
+
+    constexpr void      place(int square, int player) { pieces[player] |= (uint16_t)(1 << square); }
+    constexpr void      clear(int square, int player) { pieces[player] &= (uint16_t)~(1 << square); }
+
+    // player number at square, -1 if empty
+    constexpr int ownerAt(int square) const
+    {
+        if (pieces[0] & (1 << square)) return 0;
+        if (pieces[1] & (1 << square)) return 1;
+        return -1;
+    }
+
+    constexpr bool hasWon(int player) const
+    {
+        const uint16_t mine = pieces[player];
+        for (uint16_t line : kWinningLines) {
+            if ((mine & line) == line) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // positive if player has three in a row, negative if the opponent does, 0 otherwise
+    constexpr int evaluate(int player) const
+    {
+        if (hasWon(player)) return kWinScore;
+        if (hasWon(1 - player)) return -kWinScore;
+        return 0;
+    }
+
+    // player number of the winner, -1 if nobody has three in a row
+    constexpr int winner() const
+    {
+        if (hasWon(0)) return 0;
+        if (hasWon(1)) return 1;
+        return -1;
+    }
+};
+
+//
+// the 8 symmetries of the board (4 rotations, each optionally mirrored)
+// precomputed as mask permutations so reducing a position to its canonical
+// form is a handful of table lookups
+//
+struct TicTacToeSymmetry
+{
+    static constexpr int kCount = 8;
+
+    uint16_t    masks[kCount][TicTacToeBoard::kFullBoard + 1];     // mask transformed by symmetry t
+    uint8_t     squares[kCount][TicTacToeBoard::kSquares];         // square transformed by symmetry t
+    uint8_t     inverse[kCount][TicTacToeBoard::kSquares];         // transformed square -> original square
+    uint16_t    base3[TicTacToeBoard::kFullBoard + 1];             // sum of 3^i over the bits of a mask
+};
+
+constexpr int transformSquare(int symmetry, int square)
+{
+    int x = square % 3;
+    int y = square / 3;
+    if (symmetry & 4) {
+        x = 2 - x;
+    }
+    for (int r = 0; r < (symmetry & 3); r++) {
+        int rotated = 2 - y;
+        y = x;
+        x = rotated;
+    }
+    return y * 3 + x;
+}
+
+constexpr TicTacToeSymmetry makeTicTacToeSymmetry()
+{
+    TicTacToeSymmetry table = {};
+    for (int t = 0; t < TicTacToeSymmetry::kCount; t++) {
+        for (int square = 0; square < TicTacToeBoard::kSquares; square++) {
+            table.squares[t][square] = (uint8_t)transformSquare(t, square);
+            table.inverse[t][transformSquare(t, square)] = (uint8_t)square;
+        }
+        // every mask is a smaller mask plus its lowest bit
+        for (int mask = 1; mask <= TicTacToeBoard::kFullBoard; mask++) {
+            int low = std::countr_zero((unsigned)mask);
+            table.masks[t][mask] = table.masks[t][mask & (mask - 1)] | (uint16_t)(1 << transformSquare(t, low));
+        }
+    }
+    int power[TicTacToeBoard::kSquares] = {};
+    power[0] = 1;
+    for (int i = 1; i < TicTacToeBoard::kSquares; i++) {
+        power[i] = power[i - 1] * 3;
+    }
+    for (int mask = 1; mask <= TicTacToeBoard::kFullBoard; mask++) {
+        int low = std::countr_zero((unsigned)mask);
+        table.base3[mask] = (uint16_t)(table.base3[mask & (mask - 1)] + power[low]);
+    }
+    return table;
+}
+
+inline constexpr TicTacToeSymmetry kTicTacToeSymmetry = makeTicTacToeSymmetry();
+
+//
+// canonical index (0..kPositions-1) of the position seen from the side to move,
+// the smallest base 3 index over all 8 symmetries; symmetry receives the one used
+// so moves map to the canonical position with squares[] and back with inverse[]
+//
+constexpr int canonicalIndex(const TicTacToeBoard &board, int player, int &symmetry)
+{
+    const uint16_t mine = board.pieces[player];
+    const uint16_t theirs = board.pieces[1 - player];
+    int best = TicTacToeBoard::kPositions;
+    for (int t = 0; t < TicTacToeSymmetry::kCount; t++) {
+        int index = kTicTacToeSymmetry.base3[kTicTacToeSymmetry.masks[t][mine]]
+                  + 2 * kTicTacToeSymmetry.base3[kTicTacToeSymmetry.masks[t][theirs]];
+        if (index < best) {
+            best = index;
+            symmetry = t;
+        }
+    }
+    return best;
+}
@@ -0,0 +1,72 @@
+#include "TicTacToeSolved.h"
+
+//
+// retrograde solve of all 3^9 boards
+// adding a piece always increases the base 3 index, so walking the indices from
+// the top down means every child position is solved before its parent
+//
+static constexpr TicTacToeSolvedTable makeTicTacToeSolvedTable()
+{
+    TicTacToeSolvedTable table = {};
+
+    int power[TicTacToeBoard::kSquares] = {};
+    power[0] = 1;
+    for (int i = 1; i < TicTacToeBoard::kSquares; i++) {
+        power[i] = power[i - 1] * 3;
+    }
+
+    // start from the last index (every digit 2) and count down in base 3
+    int digits[TicTacToeBoard::kSquares] = {};
+    TicTacToeBoard board;
+    for (int i = 0; i < TicTacToeBoard::kSquares; i++) {
+        digits[i] = 2;
+        board.place(i, 1);
+    }
+
+    for (int index = TicTacToeBoard::kPositions - 1; index >= 0; index--) {
+        for (int player = 0; player < 2; player++) {
+            TicTacToeSolution &solution = table.entries[index][player];
+            solution.move = -1;
+            solution.score = (int8_t)board.evaluate(player);
+            if (solution.score != 0 || board.full()) {
+                continue;
+            }
+
+            int bestScore = -TicTacToeBoard::kWinScore - 1;
+            for (int square = 0; square < TicTacToeBoard::kSquares; square++) {
+                if (digits[square] != 0) {
+                    continue;
+                }
+                int child = table.entries[index + (player + 1) * power[square]][1 - player].score;
+                // one ply further from the end as seen from this position
+                int score = (child > 0) ? -(child - 1) : (child < 0) ? -(child + 1) : 0;
+                if (score > bestScore) {
+                    bestScore = score;
+                    solution.move = (int8_t)square;
+                }
+            }
+            solution.score = (int8_t)bestScore;
+        }
+
+        // step to index - 1
+        for (int i = 0; i < TicTacToeBoard::kSquares && index > 0; i++) {
+            if (digits[i] > 0) {
+                board.clear(i, digits[i] - 1);
+                if (--digits[i] > 0) {
+                    board.place(i, digits[i] - 1);
+                }
+                break;
+            }
+            digits[i] = 2;
+            board.place(i, 1);
+        }
+    }
+
+    return table;
+}
+
+constexpr TicTacToeSolvedTable kTicTacToeSolved = makeTicTacToeSolvedTable();
+
+// with perfect play tic tac toe is a draw
+static_assert(kTicTacToeSolved.entries[0][0].score == 0, "empty board must solve to a draw");
+static_assert(kTicTacToeSolved.entries[0][1].score == 0, "empty board must solve to a draw");
@@ -0,0 +1,33 @@
+#pragma once
+#include "TicTacToeBoard.h"
+
+//
+// every 3x3 position solved at compile time
+// entries are indexed by the base 3 index of the board (0 = empty, 1 = player 0,
+// 2 = player 1 in each digit) and by the player to move. scores use the same
+// rules and scale as negamax: kWinScore minus the plies to the end of the game,
+// seen from the player to move
+//
+struct TicTacToeSolution
+{
+    int8_t      score;
+    int8_t      move;      // best square, -1 if the game is already over
+};
+
+struct TicTacToeSolvedTable
+{
+    TicTacToeSolution entries[TicTacToeBoard::kPositions][2];
+
+    static constexpr int index(const TicTacToeBoard &board)
+    {
+        return kTicTacToeSymmetry.base3[board.pieces[0]] + 2 * kTicTacToeSymmetry.base3[board.pieces[1]];
+    }
+
+    constexpr const TicTacToeSolution &lookup(const TicTacToeBoard &board, int player) const
+    {
+        return entries[index(board)][player];
+    }
+};
+
+// built in TicTacToeSolved.cpp
+extern const TicTacToeSolvedTable kTicTacToeSolved;
@@ -1,5 +1,10 @@
 #pragma once
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
+#include <string>
+#include <vector>
+#include "PackedBoardState.h"
 
 class Game;
 class Player;
@@ -11,23 +16,68 @@ typedef enum {
 	kTurnFinished           // Turn is confirmed and finished
 } TurnStatus;
 
+//
+// one cell a turn changed: its index and its new PackedBoardState value
+// (0 empty, else player number + 1)
+//
+struct TurnChange
+{
+	uint16_t	index;
+	uint8_t		value;
+};
+
+//
+// turns are a move log rather than a board snapshot each: every turn keeps the
+// cells it changed, and every kKeyframeInterval turns one also keeps the whole
+// board as the used words of a PackedBoardState. Game::boardStateAt rebuilds
+// any turn's board from the keyframe before it
+//
 class Turn
 {
 public:
-	Turn() : _game(nullptr), _player(nullptr), _status(kTurnEmpty), _move(""), _boardState(""), _date(0), _comment(""), _score(0), _replaying(false), _gameNumber(-1) {};
+	static constexpr int kKeyframeInterval = 32;
+
+	Turn() : _game(nullptr), _player(nullptr), _status(kTurnEmpty), _date(0), _score(0), _replaying(false), _gameNumber(-1), _keyframeCells(0) {};
 	~Turn() {};
 
-	static	Turn *initStartOfGame(Game *game) { Turn *turn = new Turn(); turn->_game = game; turn->_status = kTurnFinished; return turn; };
-	void	setStateString(std::string board) { _boardState = board; };
+	// back to a freshly constructed turn, the vectors keep their buffers for reuse
+	void	reset()
+	{
+		_game = nullptr;
+		_player = nullptr;
+		_status = kTurnEmpty;
+		_changes.clear();
+		_keyframe.clear();
+		_keyframeCells = 0;
+		_date = 0;
+		_score = 0;
+		_replaying = false;
+		_gameNumber = -1;
+	}
+
+	bool	isKeyframe() const { return !_keyframe.empty(); }
+	void	setKeyframe(const PackedBoardState &board)
+	{
+		_keyframe.assign(board.words, board.words + board.usedWords());
+		_keyframeCells = board.cellCount;
+	}
+	void	getKeyframe(PackedBoardState &board) const
+	{
+		board.clear(_keyframeCells);
+		std::copy(_keyframe.begin(), _keyframe.end(), board.words);
+	}
+
 	Game		*_game;
 	Player		*_player;
 	TurnStatus	_status;
-	std::string	_move;
-	std::string	_boardState;
+	// cells changed since the turn before
+	std::vector<TurnChange>	_changes;
+	// packed board words, only on keyframe turns
+	std::vector<uint64_t>	_keyframe;
 	int			_date;
-	std::string	_comment;
 	int			_score;
 	bool		_replaying;
 	int			_gameNumber;
+	// cells the keyframe covers
+	int			_keyframeCells;
 };
-
@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+
+//
+// zobrist keys: one random 64 bit number per (cell, player). a position's key is the
+// xor of the keys of every piece on it, so placing or removing a piece is one xor and
+// the key never has to be rebuilt from the board. the table is filled by the compiler
+// from a fixed seed, so keys are the same on every run and in every copy of a board
+//
+struct ZobristTable
+{
+    // enough cells for a KInARowBoard::kMaxDimension square board
+    static constexpr int kMaxCells = 32 * 32;
+    static constexpr int kMaxPlayers = 4;
+
+    uint64_t    keys[kMaxCells][kMaxPlayers];
+};
+
+constexpr ZobristTable makeZobristTable()
+{
+    ZobristTable table = {};
+    // splitmix64
+    uint64_t state = 0x5A0B215F0D1E2C3BULL;
+    for (int cell = 0; cell < ZobristTable::kMaxCells; cell++) {
+        for (int player = 0; player < ZobristTable::kMaxPlayers; player++) {
+            state += 0x9E3779B97F4A7C15ULL;
+            uint64_t z = state;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            table.keys[cell][player] = z ^ (z >> 31);
+        }
+    }
+    return table;
+}
+
+inline constexpr ZobristTable kZobrist = makeZobristTable();
+
+inline uint64_t zobristKey(int cell, int player)
+{
+    return kZobrist.keys[cell][player];
+}
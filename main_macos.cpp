@@ -11,6 +11,8 @@
 #include "imgui/imgui_impl_glfw.h"
 #include "imgui/imgui_impl_opengl3.h"
 #include <stdio.h>
+#include <chrono>
+#include <thread>
 #define GL_SILENCE_DEPRECATION
 #if defined(IMGUI_IMPL_OPENGL_ES2)
 #include <GLES2/gl2.h>
@@ -121,6 +123,12 @@ int main(int, char**)
     bool show_another_window = false;
     ImVec4 clear_color = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
     ClassGame::GameStartUp();
+
+    // frames drawn after an event before the loop goes back to sleep,
+    // imgui needs a couple to settle hover and focus changes
+    const int kSettleFrames = 3;
+    int settleFrames = kSettleFrames;
+    double lastFrameTime = glfwGetTime();
     
     // Main loop
 #ifdef __EMSCRIPTEN__
@@ -137,7 +145,30 @@ int main(int, char**)
         // - When io.WantCaptureMouse is true, do not dispatch mouse input data to your main application, or clear/overwrite your copy of the mouse data.
         // - When io.WantCaptureKeyboard is true, do not dispatch keyboard input data to your main application, or clear/overwrite your copy of the keyboard data.
         // Generally you may always pass all inputs to dear imgui, and hide them from your application based on those two flags.
+#ifdef __EMSCRIPTEN__
         glfwPollEvents();
+#else
+        if (ClassGame::IsAnimating()) {
+            // the frames after it stops show what it changed, like the AI's move
+            settleFrames = kSettleFrames;
+        }
+        if (settleFrames <= 0) {
+            // nothing on screen can change until the next event
+            glfwWaitEvents();
+            settleFrames = kSettleFrames;
+        } else {
+            const int maxFrameRate = ClassGame::MaxFrameRate();
+            if (maxFrameRate > 0) {
+                const double wait = lastFrameTime + 1.0 / maxFrameRate - glfwGetTime();
+                if (wait > 0.0) {
+                    std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+                }
+            }
+            glfwPollEvents();
+            settleFrames--;
+        }
+        lastFrameTime = glfwGetTime();
+#endif
 
         // Start the Dear ImGui frame
         ImGui_ImplOpenGL3_NewFrame();
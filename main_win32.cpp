@@ -11,6 +11,8 @@
 #include "imgui/imgui_impl_dx11.h"
 #include <d3d11.h>
 #include <tchar.h>
+#include <chrono>
+#include <thread>
 #include "Application.h"
 
 // Data
@@ -108,10 +110,33 @@ int main(int, char**)
     // Our state
     ClassGame::GameStartUp();
 
+    // frames drawn after a message before the loop goes back to sleep,
+    // imgui needs a couple to settle hover and focus changes
+    const int kSettleFrames = 3;
+    int settleFrames = kSettleFrames;
+    auto lastFrameTime = std::chrono::steady_clock::now();
+
     // Main loop
     bool done = false;
     while (!done)
     {
+        if (ClassGame::IsAnimating()) {
+            // the frames after it stops show what it changed, like the AI's move
+            settleFrames = kSettleFrames;
+        }
+        if (settleFrames <= 0) {
+            // nothing on screen can change until the next message
+            ::WaitMessage();
+            settleFrames = kSettleFrames;
+        } else {
+            const int maxFrameRate = ClassGame::MaxFrameRate();
+            if (maxFrameRate > 0) {
+                std::this_thread::sleep_until(lastFrameTime + std::chrono::microseconds(1000000 / maxFrameRate));
+            }
+            settleFrames--;
+        }
+        lastFrameTime = std::chrono::steady_clock::now();
+
         // Poll and handle messages (inputs, window resize, etc.)
         // See the WndProc() function below for our to dispatch events to the Win32 backend.
         MSG msg;
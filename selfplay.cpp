@@ -0,0 +1,194 @@
+//
+// headless self play: the AI plays itself over and over with no window,
+// for regression runs on machines without a display
+//
+// selfplay [--games n] [--board columns rows k] [--openings plies] [--time ms]
+//          [--threads n] [--vary-threads] [--seed n] [--solved | --mcts] [--expect-draws]
+//
+// exits non-zero when the AI fails to move, the turn history doesn't rebuild
+// the board, or with --expect-draws any game isn't drawn, so CTest can run it
+//
+
+#include "classes/TicTacToe.h"
+#include "Application.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace ClassGame {
+        //
+        // the game calls this at the end of every turn, the driver below
+        // checks for a winner itself so there is nothing to do here
+        //
+        void EndOfTurn()
+        {
+        }
+}
+
+struct SelfPlayOptions
+{
+    int         games = 100;
+    int         columns = 3;
+    int         rows = 3;
+    int         winLength = 3;
+    int         openings = 2;       // random plies before the AI takes over
+    int         timeBudget = 50;
+    int         threads = 1;
+    unsigned    seed = 1;
+    AIMode      mode = kAIModeNegamax;
+    bool        expectDraws = false;    // perfect play on both sides, every game must be drawn
+    bool        varyThreads = false;    // cycle from 1 to threads, a different count every move
+};
+
+static void usage()
+{
+    printf("usage: selfplay [--games n] [--board columns rows k] [--openings plies] [--time ms]\n"
+           "                [--threads n] [--vary-threads] [--seed n] [--solved | --mcts] [--expect-draws]\n");
+}
+
+static bool parseOptions(int argc, char **argv, SelfPlayOptions &options)
+{
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const int remaining = argc - i - 1;
+        if (strcmp(arg, "--games") == 0 && remaining >= 1) {
+            options.games = atoi(argv[++i]);
+        } else if (strcmp(arg, "--board") == 0 && remaining >= 3) {
+            options.columns = atoi(argv[++i]);
+            options.rows = atoi(argv[++i]);
+            options.winLength = atoi(argv[++i]);
+        } else if (strcmp(arg, "--openings") == 0 && remaining >= 1) {
+            options.openings = atoi(argv[++i]);
+        } else if (strcmp(arg, "--time") == 0 && remaining >= 1) {
+            options.timeBudget = atoi(argv[++i]);
+        } else if (strcmp(arg, "--threads") == 0 && remaining >= 1) {
+            options.threads = atoi(argv[++i]);
+        } else if (strcmp(arg, "--seed") == 0 && remaining >= 1) {
+            options.seed = (unsigned)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(arg, "--solved") == 0) {
+            options.mode = kAIModeSolvedTable;
+        } else if (strcmp(arg, "--mcts") == 0) {
+            options.mode = kAIModeMCTS;
+        } else if (strcmp(arg, "--vary-threads") == 0) {
+            options.varyThreads = true;
+        } else if (strcmp(arg, "--expect-draws") == 0) {
+            options.expectDraws = true;
+        } else {
+            return false;
+        }
+    }
+    return options.games > 0;
+}
+
+//
+// play random moves for both sides, the same way a click would
+//
+static void playOpening(TicTacToe &game, int plies, std::mt19937 &random)
+{
+    game._aiEnabled = false;
+    for (int ply = 0; ply < plies && !game.checkForWinner() && !game.checkForDraw(); ply++) {
+        std::vector<BitHolder*> empties;
+        for (int y = 0; y < game._gameOptions.rowY; y++) {
+            for (int x = 0; x < game._gameOptions.rowX; x++) {
+                BitHolder &holder = game.getHolderAt(x, y);
+                if (holder.empty()) {
+                    empties.push_back(&holder);
+                }
+            }
+        }
+        BitHolder *holder = empties[random() % empties.size()];
+        if (game.actionForEmptyHolder(holder)) {
+            game.endTurn();
+        }
+    }
+    game._aiEnabled = true;
+}
+
+int main(int argc, char **argv)
+{
+    SelfPlayOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        usage();
+        return 2;
+    }
+
+    TicTacToe game;
+    game._aiThreaded = false;
+    game._aiMode = options.mode;
+    game._gameOptions.AIvsAI = true;
+    game._gameOptions.AITimeBudget = options.timeBudget;
+    game._gameOptions.AIThreads = options.threads;
+    game.setBoardSize(options.columns, options.rows, options.winLength);
+
+    std::mt19937 random(options.seed);
+    int results[3] = { 0, 0, 0 };      // X wins, O wins, draws
+    long long moves = 0;
+    long long nodes = 0;
+    int stalled = 0;
+    int badHistory = 0;
+    PackedBoardState history;
+    PackedBoardState board;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int g = 0; g < options.games; g++) {
+        game.stopGame();
+        game.setUpBoard();
+        playOpening(game, options.openings, random);
+
+        while (!game.checkForWinner() && !game.checkForDraw()) {
+            const unsigned int turn = game.getCurrentTurnNo();
+            if (options.varyThreads) {
+                game._gameOptions.AIThreads = 1 + (int)(turn % std::max(options.threads, 1));
+            }
+            game.updateAI();
+            // every updateAI has to play a move, anything else is a broken AI
+            if (game.getCurrentTurnNo() == turn) {
+                stalled++;
+                break;
+            }
+            nodes += game._gameOptions.AIDepthSearches;
+        }
+
+        // the move log played back from its keyframes has to land on the board as it is
+        game.boardStateAt(game._turns.size() - 1, history);
+        game.getPackedState(board);
+        if (history != board) {
+            badHistory++;
+        }
+
+        Player *winner = game.checkForWinner();
+        results[winner ? winner->playerNumber() : 2]++;
+        moves += game.getCurrentTurnNo();
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const char *modeNames[] = { "negamax", "solved table", "mcts" };
+    const char *modeName = modeNames[options.mode];
+    printf("%d games on %dx%d, %d in a row (%s, %d random opening plies, %d ms per move)\n",
+           options.games, game._gameOptions.rowX, game._gameOptions.rowY, game.getWinLength(),
+           modeName, options.openings, options.timeBudget);
+    printf("  %.3f s, %.1f games/sec, %.1f moves/game, %.0f nodes/sec\n",
+           seconds, options.games / seconds, (double)moves / options.games, nodes / seconds);
+    const char *labels[3] = { "X wins", "O wins", "draws" };
+    for (int i = 0; i < 3; i++) {
+        printf("  %-7s %6d  %5.1f%%\n", labels[i], results[i], 100.0 * results[i] / options.games);
+    }
+    if (stalled > 0) {
+        printf("  %d games stalled with no AI move\n", stalled);
+    }
+    if (badHistory > 0) {
+        printf("  %d games whose turn history doesn't rebuild the final board\n", badHistory);
+    }
+    const bool undrawn = options.expectDraws && results[2] != options.games;
+    if (undrawn) {
+        printf("  %d games weren't drawn\n", options.games - results[2]);
+    }
+    if (stalled > 0 || badHistory > 0 || undrawn) {
+        return 1;
+    }
+    return 0;
+}